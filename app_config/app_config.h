@@ -1,5 +1,8 @@
 #pragma once
 #include <drogon/drogon.h>
 
+// Файл конфигурации в рабочей директории
+inline constexpr char kConfigFile[] = "config.json";
+
 void configureApplication();
-void setupSecurityHeaders();
\ No newline at end of file
+void setupSecurityHeaders();
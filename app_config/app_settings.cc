@@ -0,0 +1,209 @@
+#include "app_settings.h"
+#include "../storage/car_record_format.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Пределы проверяемых значений
+constexpr unsigned kMaxThreads = 256;
+// Пределы числа итераций совпадают с допустимыми в заголовке записи
+constexpr int kMinPbkdf2Iterations = static_cast<int>(car_record::kMinIterations);
+constexpr int kMaxPbkdf2Iterations = static_cast<int>(car_record::kMaxIterations);
+constexpr int64_t kMaxGroupCommitWindowMs = 1000;
+constexpr int64_t kMaxGroupCommitBatch = 1000;
+constexpr int64_t kMaxWorkloadConcurrency = 100000;
+constexpr int64_t kMaxWorkloadQueue = 100000;
+constexpr int64_t kMaxWorkloadConnections = 1024;
+constexpr int64_t kMaxWorkloadTimeoutMs = 3600 * 1000;
+constexpr int64_t kMaxFastReadConnections = 64;
+
+// Текущий снимок (std::atomic_load/atomic_store)
+std::shared_ptr<const AppSettings> g_settings;
+
+// Целое значение в допустимом диапазоне
+int64_t readInt(const Json::Value& section, const char* name, int64_t fallback,
+                int64_t min, int64_t max) {
+    const Json::Value& value = section[name];
+    if (value.isNull()) return fallback;
+    if (!value.isIntegral()) {
+        throw std::runtime_error(std::string("Параметр ") + name + " должен быть целым числом");
+    }
+    const int64_t result = value.asInt64();
+    if (result < min || result > max) {
+        throw std::runtime_error(std::string("Параметр ") + name + " вне диапазона " +
+                                 std::to_string(min) + ".." + std::to_string(max));
+    }
+    return result;
+}
+
+// Пределы одного класса нагрузки (подсекция workloads)
+void readWorkload(const Json::Value& workloads, Workload workload, WorkloadLimits& limits) {
+    const char* name = workloadName(workload);
+    const Json::Value& section = workloads[name];
+    if (section.isNull()) return;
+    if (!section.isObject()) {
+        throw std::runtime_error(std::string("Некорректная секция workloads.") + name + " в конфигурации");
+    }
+    limits.concurrency = static_cast<size_t>(
+        readInt(section, "concurrency", limits.concurrency, 1, kMaxWorkloadConcurrency));
+    limits.queue = static_cast<size_t>(readInt(section, "queue", limits.queue, 0, kMaxWorkloadQueue));
+    if (workload != Workload::Ingest) {
+        limits.connections = static_cast<size_t>(
+            readInt(section, "connections", limits.connections, 1, kMaxWorkloadConnections));
+    } else if (section.isMember("connections")) {
+        throw std::runtime_error("Класс ingest использует основной пул: параметр connections не задается");
+    }
+    limits.timeout = std::chrono::milliseconds(
+        readInt(section, "timeout_ms", limits.timeout.count(), 0, kMaxWorkloadTimeoutMs));
+}
+}
+
+WorkloadTable AppSettings::defaultWorkloads() {
+    WorkloadTable table;
+    table[static_cast<size_t>(Workload::Interactive)] = {256, 1024, 4, std::chrono::milliseconds(2000)};
+    table[static_cast<size_t>(Workload::Report)] = {4, 32, 4, std::chrono::milliseconds(30000)};
+    table[static_cast<size_t>(Workload::Ingest)] = {8, 64, 0, std::chrono::milliseconds(60000)};
+    return table;
+}
+
+bool AppSettings::restartRequired(const AppSettings& other) const {
+    if (listenAddress != other.listenAddress || port != other.port || threads != other.threads
+        || readHost != other.readHost || readPort != other.readPort
+        || fastReadConnections != other.fastReadConnections) {
+        return true;
+    }
+    for (size_t i = 0; i < kWorkloadCount; ++i) {
+        if (workloads[i].connections != other.workloads[i].connections
+            || workloads[i].timeout != other.workloads[i].timeout) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AppSettings::keepStartupValues(const AppSettings& running) {
+    listenAddress = running.listenAddress;
+    port = running.port;
+    threads = running.threads;
+    readHost = running.readHost;
+    readPort = running.readPort;
+    fastReadConnections = running.fastReadConnections;
+    for (size_t i = 0; i < kWorkloadCount; ++i) {
+        workloads[i].connections = running.workloads[i].connections;
+        workloads[i].timeout = running.workloads[i].timeout;
+    }
+}
+
+// Чтение и разбор файла конфигурации
+Json::Value readConfigFile(const std::string& path) {
+    // Проверка существования конфигурационного файла
+    if (!fs::exists(path)) {
+        throw std::runtime_error("Файл " + path + " не найден в рабочей директории");
+    }
+
+    // Открытие файла для чтения
+    std::ifstream configFile(path);
+    if (!configFile) {
+        throw std::runtime_error("Не удалось открыть " + path);
+    }
+
+    // Парсинг JSON с обработкой ошибок
+    Json::CharReaderBuilder readerBuilder;
+    Json::Value config;
+    std::string errs;
+    if (!Json::parseFromStream(readerBuilder, configFile, &config, &errs)) {
+        throw std::runtime_error("Ошибка парсинга " + path + ": " + errs);
+    }
+    return config;
+}
+
+// Проверка структуры и значений конфигурации
+std::shared_ptr<const AppSettings> parseSettings(const Json::Value& config) {
+    if (!config.isObject()) {
+        throw std::runtime_error("Конфигурация должна быть JSON-объектом");
+    }
+    if (!config.isMember("server") || !config["server"].isObject()) {
+        throw std::runtime_error("Некорректная секция server в конфигурации");
+    }
+    const Json::Value& server = config["server"];
+    const Json::Value& security = config["security"];
+    if (!security.isNull() && !security.isObject()) {
+        throw std::runtime_error("Некорректная секция security в конфигурации");
+    }
+    const Json::Value& database = config["database"];
+    if (!database.isNull() && !database.isObject()) {
+        throw std::runtime_error("Некорректная секция database в конфигурации");
+    }
+    const Json::Value& maintenance = config["maintenance"];
+    if (!maintenance.isNull() && !maintenance.isObject()) {
+        throw std::runtime_error("Некорректная секция maintenance в конфигурации");
+    }
+    const Json::Value& workloads = config["workloads"];
+    if (!workloads.isNull() && !workloads.isObject()) {
+        throw std::runtime_error("Некорректная секция workloads в конфигурации");
+    }
+
+    auto settings = std::make_shared<AppSettings>();
+
+    const Json::Value& address = server["listen_address"];
+    if (!address.isNull()) {
+        if (!address.isString() || address.asString().empty()) {
+            throw std::runtime_error("Параметр listen_address должен быть непустой строкой");
+        }
+        settings->listenAddress = address.asString();
+    }
+    settings->port = static_cast<uint16_t>(readInt(server, "port", 8080, 1, 65535));
+    settings->threads = static_cast<unsigned>(
+        readInt(server, "threads", std::max(1u, std::thread::hardware_concurrency()), 1, kMaxThreads));
+
+    const Json::Value& readHost = database["read_host"];
+    if (!readHost.isNull()) {
+        if (!readHost.isString()) {
+            throw std::runtime_error("Параметр read_host должен быть строкой");
+        }
+        settings->readHost = readHost.asString();
+    }
+    settings->readPort = static_cast<uint16_t>(readInt(database, "read_port", 0, 0, 65535));
+    settings->fastReadConnections = static_cast<size_t>(
+        readInt(database, "fast_read_connections", 0, 0, kMaxFastReadConnections));
+
+    const Json::Value& origins = security["allowed_origins"];
+    if (!origins.isNull()) {
+        if (!origins.isArray()) {
+            throw std::runtime_error("Параметр allowed_origins должен быть массивом строк");
+        }
+        for (const auto& origin : origins) {
+            if (!origin.isString() || origin.asString().empty()) {
+                throw std::runtime_error("Параметр allowed_origins должен быть массивом строк");
+            }
+            settings->allowedOrigins.push_back(origin.asString());
+        }
+    }
+    settings->pbkdf2Iterations = static_cast<int>(readInt(
+        security, "pbkdf2_iterations", 100000, kMinPbkdf2Iterations, kMaxPbkdf2Iterations));
+
+    settings->policy = std::make_shared<SecurityPolicy>(settings->allowedOrigins);
+
+    settings->groupCommitWindow = std::chrono::milliseconds(
+        readInt(maintenance, "group_commit_window_ms", 5, 0, kMaxGroupCommitWindowMs));
+    settings->groupCommitMaxBatch = static_cast<size_t>(
+        readInt(maintenance, "group_commit_max_batch", 64, 1, kMaxGroupCommitBatch));
+
+    for (size_t i = 0; i < kWorkloadCount; ++i) {
+        readWorkload(workloads, static_cast<Workload>(i), settings->workloads[i]);
+    }
+    return settings;
+}
+
+std::shared_ptr<const AppSettings> currentSettings() {
+    return std::atomic_load(&g_settings);
+}
+
+void publishSettings(std::shared_ptr<const AppSettings> settings) {
+    std::atomic_store(&g_settings, std::move(settings));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "security_policy.h"
+#include "workload.h"
+#include <json/json.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Типизированный снимок конфигурации (config.json). Снимок неизменяем
+// и публикуется атомарной заменой указателя: горячие пути читают поля
+// структуры, а не выполняют поиск по Json::Value.
+struct AppSettings {
+    // server — применяются только при старте
+    std::string listenAddress = "0.0.0.0";
+    uint16_t port = 8080;
+    unsigned threads = 0;                 // 0 — по числу ядер
+
+    // database — применяются только при старте
+    std::string readHost;                 // Сервер чтения (реплика; пусто — DB_HOST)
+    uint16_t readPort = 0;                // Порт сервера чтения (0 — DB_PORT)
+    size_t fastReadConnections = 0;       // Быстрые клиенты чтения на IO-поток (0 — нет)
+
+    // security — применяются без перезапуска
+    std::vector<std::string> allowedOrigins;
+    int pbkdf2Iterations = 100000;
+    std::shared_ptr<const SecurityPolicy> policy;  // Собранная политика CORS
+
+    // maintenance — применяются без перезапуска
+    std::chrono::milliseconds groupCommitWindow{5};  // Окно сбора /add-maintenance (0 — без объединения)
+    size_t groupCommitMaxBatch = 64;                  // Предел запросов в одной записи
+
+    // workloads — бюджеты и очереди без перезапуска, пулы и таймауты при старте
+    WorkloadTable workloads = defaultWorkloads();
+
+    // Пределы классов нагрузки по умолчанию
+    static WorkloadTable defaultWorkloads();
+
+    // Изменены ли настройки, требующие перезапуска
+    bool restartRequired(const AppSettings& other) const;
+
+    // Перенос значений, применяемых только при старте, из работающего
+    // снимка: опубликованный снимок описывает то, что действует на самом деле
+    void keepStartupValues(const AppSettings& running);
+};
+
+// Чтение JSON-файла конфигурации; std::runtime_error при ошибке
+Json::Value readConfigFile(const std::string& path);
+
+// Разбор и проверка значений; std::runtime_error при ошибке
+std::shared_ptr<const AppSettings> parseSettings(const Json::Value& config);
+
+// Текущий снимок (nullptr до загрузки конфигурации)
+std::shared_ptr<const AppSettings> currentSettings();
+void publishSettings(std::shared_ptr<const AppSettings> settings);
@@ -0,0 +1,63 @@
+#include "config_reloader.h"
+#include <drogon/drogon.h>
+#include <atomic>
+
+using namespace drogon;
+
+namespace {
+// Период проверки запроса на перезагрузку (секунды)
+constexpr double kReloadPollInterval = 1.0;
+
+// Флаг, выставляемый обработчиком SIGHUP
+std::atomic<bool> g_reloadRequested{false};
+static_assert(std::atomic<bool>::is_always_lock_free, "Флаг используется в обработчике сигнала");
+}
+
+ConfigReloader::ConfigReloader(std::string path, Listener listener)
+    : path_(std::move(path)), listener_(std::move(listener)) {
+    watcher_ = std::make_unique<FileWatcher>(path_, [this] { reload(); });
+    timerId_ = app().getLoop()->runEvery(kReloadPollInterval, [this] {
+        if (g_reloadRequested.exchange(false)) {
+            reload();
+        }
+    });
+}
+
+ConfigReloader::~ConfigReloader() {
+    app().getLoop()->invalidateTimer(timerId_);
+    watcher_.reset(); // Остановка потока наблюдателя до разрушения полей
+}
+
+bool ConfigReloader::reload() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<const AppSettings> next;
+    try {
+        next = parseSettings(readConfigFile(path_));
+    } catch (const std::exception& e) {
+        // Редактор мог сохранить файл частично: оставляем прежние настройки
+        LOG_ERROR << "Конфигурация не перезагружена: " << e.what();
+        return false;
+    }
+
+    // Значения, применяемые только при старте, остаются прежними: prev
+    // всегда описывает действующие пулы, и предупреждение повторяется,
+    // пока файл с ними расходится
+    const auto prev = currentSettings();
+    if (prev) {
+        auto applied = std::make_shared<AppSettings>(*next);
+        applied->keepStartupValues(*prev);
+        if (prev->restartRequired(*next)) {
+            LOG_WARN << "Изменения секций server, database и пулов/таймаутов workloads вступят в силу после перезапуска";
+        }
+        next = std::move(applied);
+    }
+    publishSettings(next);
+    LOG_INFO << "Конфигурация перезагружена из " << path_;
+
+    if (prev) listener_(*prev, *next);
+    return true;
+}
+
+void ConfigReloader::requestReload() {
+    g_reloadRequested.store(true, std::memory_order_relaxed);
+}
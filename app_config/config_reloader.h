@@ -0,0 +1,37 @@
+#pragma once
+
+#include "app_settings.h"
+#include "../utilities/file_watcher.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Перезагрузка config.json без перезапуска сервера: по изменению файла
+// (inotify) или по сигналу SIGHUP. Новый снимок проверяется целиком и
+// публикуется атомарно; при ошибке остается действующий снимок.
+class ConfigReloader {
+public:
+    // Применение нового снимка (prev — действующий до перезагрузки)
+    using Listener = std::function<void(const AppSettings& prev, const AppSettings& next)>;
+
+    ConfigReloader(std::string path, Listener listener);
+    ~ConfigReloader();
+
+    ConfigReloader(const ConfigReloader&) = delete;
+    ConfigReloader& operator=(const ConfigReloader&) = delete;
+
+    // Повторное чтение файла; false — файл некорректен, снимок не изменен
+    bool reload();
+
+    // Запрос перезагрузки из обработчика сигнала (async-signal-safe);
+    // обрабатывается таймером в главном цикле приложения
+    static void requestReload();
+
+private:
+    std::string path_;                      // Путь к файлу конфигурации
+    Listener listener_;                     // Применение изменений
+    std::mutex mutex_;                      // Сериализация перезагрузок
+    std::unique_ptr<FileWatcher> watcher_;  // Наблюдатель за файлом
+    uint64_t timerId_ = 0;                  // Таймер проверки запроса SIGHUP
+};
@@ -0,0 +1,115 @@
+#include "security_policy.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+// Предел кэша решений и длины проверяемого Origin
+constexpr size_t kDecisionCacheSize = 256;
+constexpr size_t kMaxOriginLength = 256;
+
+std::string toLower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+}
+
+// Сборка политики из шаблонов allowed_origins
+SecurityPolicy::SecurityPolicy(const std::vector<std::string>& allowedOrigins) {
+    for (const auto& item : allowedOrigins) {
+        const std::string pattern = toLower(item);
+        if (pattern.empty()) continue;
+
+        if (pattern == "*") {
+            allowAll_ = true;
+        } else if (pattern.find('*') == std::string::npos) {
+            exact_.insert(pattern);
+        } else {
+            Glob glob;
+            glob.leadingStar = pattern.front() == '*';
+            glob.trailingStar = pattern.back() == '*';
+            size_t pos = 0;
+            while (pos <= pattern.size()) {
+                const size_t star = pattern.find('*', pos);
+                const size_t end = star == std::string::npos ? pattern.size() : star;
+                if (end > pos) glob.parts.emplace_back(pattern, pos, end - pos);
+                if (star == std::string::npos) break;
+                pos = star + 1;
+            }
+            globs_.push_back(std::move(glob));
+        }
+    }
+
+    staticHeaders_ = {
+        {"X-Content-Type-Options", "nosniff"},   // Защита от MIME-sniffing
+        {"X-Frame-Options", "DENY"},             // Запрет встраивания в фреймы
+        {"X-XSS-Protection", "1; mode=block"},   // Включение XSS-фильтра
+    };
+}
+
+// Проверка источника: точное совпадение, затем кэш и шаблоны
+bool SecurityPolicy::allowOrigin(std::string_view origin) const {
+    if (origin.empty() || origin.size() > kMaxOriginLength) return false;
+    if (allowAll_) return true;
+
+    const std::string lower = toLower(origin);
+    if (exact_.count(lower)) return true;
+    if (globs_.empty()) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto found = decisions_.find(lower);
+        if (found != decisions_.end()) return found->second;
+    }
+
+    bool allowed = false;
+    for (const auto& glob : globs_) {
+        if (matches(glob, lower)) {
+            allowed = true;
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (decisions_.size() >= kDecisionCacheSize) decisions_.clear();
+    decisions_.emplace(lower, allowed);
+    return allowed;
+}
+
+// Сопоставление с шаблоном: первая часть — префикс, последняя — суффикс,
+// средние ищутся по порядку (поиск слева направо достаточен для '*')
+bool SecurityPolicy::matches(const Glob& glob, std::string_view origin) {
+    const auto& parts = glob.parts;
+    if (parts.empty()) return true;
+
+    size_t begin = 0;
+    size_t end = origin.size();
+    size_t first = 0;
+    size_t last = parts.size();
+
+    if (!glob.leadingStar) {
+        if (origin.compare(0, parts[0].size(), parts[0]) != 0) return false;
+        begin = parts[0].size();
+        first = 1;
+    }
+    if (!glob.trailingStar && last > first) {
+        const std::string& suffix = parts[last - 1];
+        if (suffix.size() > end - begin ||
+            origin.compare(end - suffix.size(), suffix.size(), suffix) != 0) {
+            return false;
+        }
+        end -= suffix.size();
+        --last;
+    } else if (!glob.trailingStar && begin != end) {
+        // Шаблон без '*' в конце, вся строка уже поглощена префиксом
+        return false;
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        const size_t pos = origin.substr(0, end).find(parts[i], begin);
+        if (pos == std::string_view::npos) return false;
+        begin = pos + parts[i].size();
+    }
+    return true;
+}
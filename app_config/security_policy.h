@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Политика CORS и заголовков безопасности, собранная один раз при загрузке
+// конфигурации (входит в снимок AppSettings). Шаблоны allowed_origins разбираются
+// в точные значения и glob-шаблоны ('*' — любая последовательность
+// символов, сравнение без учета регистра); результаты проверки по
+// шаблонам запоминаются в ограниченном кэше решений.
+class SecurityPolicy {
+public:
+    using Header = std::pair<std::string, std::string>;
+
+    explicit SecurityPolicy(const std::vector<std::string>& allowedOrigins);
+
+    SecurityPolicy(const SecurityPolicy&) = delete;
+    SecurityPolicy& operator=(const SecurityPolicy&) = delete;
+
+    // Разрешен ли источник запроса
+    bool allowOrigin(std::string_view origin) const;
+
+    // Заголовки безопасности, добавляемые к каждому ответу
+    const std::vector<Header>& staticHeaders() const { return staticHeaders_; }
+
+private:
+    // Шаблон, разбитый по '*': части сопоставляются по порядку
+    struct Glob {
+        std::vector<std::string> parts;
+        bool leadingStar;
+        bool trailingStar;
+    };
+
+    static bool matches(const Glob& glob, std::string_view origin);
+
+    bool allowAll_ = false;                    // Шаблон "*"
+    std::unordered_set<std::string> exact_;    // Точные источники (нижний регистр)
+    std::vector<Glob> globs_;                  // Шаблоны со звездочками
+    std::vector<Header> staticHeaders_;
+
+    // Кэш решений по шаблонам (очищается при заполнении)
+    mutable std::mutex cacheMutex_;
+    mutable std::unordered_map<std::string, bool> decisions_;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+// Классы нагрузки: у каждого свой бюджет одновременных запросов, очередь
+// ожидания и таймаут запросов к БД, чтобы тяжелые отчеты не вытесняли
+// короткие запросы
+enum class Workload : size_t {
+    Interactive,  // Справочники, данные автомобиля, остаток пробега
+    Report,       // Отчеты (в том числе потоковые)
+    Ingest,       // Запись ТО и потоковая загрузка
+    Count
+};
+
+constexpr size_t kWorkloadCount = static_cast<size_t>(Workload::Count);
+
+// Пределы класса (секция workloads конфигурации)
+struct WorkloadLimits {
+    size_t concurrency = 0;            // Одновременно обрабатываемые запросы
+    size_t queue = 0;                  // Запросы, ожидающие очереди (сверх — 503)
+    size_t connections = 0;            // Собственный пул чтения (только при старте; у ingest — основной пул)
+    std::chrono::milliseconds timeout{0};  // Таймаут запроса к БД (только при старте; 0 — без таймаута)
+};
+
+using WorkloadTable = std::array<WorkloadLimits, kWorkloadCount>;
+
+// Имя класса в конфигурации и метриках
+const char* workloadName(Workload workload);
@@ -0,0 +1,187 @@
+#include "workload_gate.h"
+#include "app_settings.h"
+#include <drogon/HttpAppFramework.h>
+#include <trantor/net/TcpConnection.h>
+#include <string_view>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+// Атрибут запроса, занявшего место класса
+constexpr char kWorkloadAttribute[] = "workload";
+
+// Маршрут класса нагрузки (Invalid — любой метод)
+struct Route {
+    std::string_view pattern;
+    HttpMethod method;
+    Workload workload;
+};
+
+constexpr Route kRoutes[] = {
+    {"/car/create", Invalid, Workload::Interactive},
+    {"/car/info", Invalid, Workload::Interactive},
+    {"/car/update", Invalid, Workload::Interactive},
+    {"/cars", Invalid, Workload::Interactive},
+    {"/car/{vin}/info", Invalid, Workload::Interactive},
+    {"/car/{vin}/update", Invalid, Workload::Interactive},
+    {"/dates", Invalid, Workload::Interactive},
+    {"/maintenance-dates", Invalid, Workload::Interactive},
+    {"/nodes", Invalid, Workload::Interactive},
+    {"/nodes/{node_name}/subnodes", Invalid, Workload::Interactive},
+    {"/service/remaining-km", Invalid, Workload::Interactive},
+    {"/reports/{node_name}/{date}", Invalid, Workload::Report},
+    {"/daily-reports/{date}", Invalid, Workload::Report},
+    {"/period-reports", Invalid, Workload::Report},
+    {"/maintenance-reports", Invalid, Workload::Report},
+    {"/add-maintenance", Post, Workload::Ingest},
+    {"/add-maintenance/stream", Post, Workload::Ingest},
+};
+
+// Через сколько секунд повторять запрос после отказа
+constexpr const char* kRetryAfter[kWorkloadCount] = {"1", "5", "2"};
+
+const WorkloadLimits& limitsOf(const AppSettings& settings, Workload workload) {
+    return settings.workloads[static_cast<size_t>(workload)];
+}
+
+// Отказ при заполненной очереди класса
+void sendBusy(const std::function<void(const HttpResponsePtr&)>& callback, Workload workload) {
+    Json::Value error;
+    error["error"] = "Server is busy, retry later";
+    error["workload"] = workloadName(workload);
+    auto resp = HttpResponse::newHttpJsonResponse(error);
+    resp->setStatusCode(k503ServiceUnavailable);
+    resp->addHeader("Retry-After", kRetryAfter[static_cast<size_t>(workload)]);
+    callback(resp);
+}
+}
+
+const char* workloadName(Workload workload) {
+    switch (workload) {
+        case Workload::Interactive: return "interactive";
+        case Workload::Report: return "report";
+        case Workload::Ingest: return "ingest";
+        case Workload::Count: break;
+    }
+    return "unknown";
+}
+
+bool WorkloadGate::classify(const HttpRequestPtr& req, Workload& workload) {
+    const std::string_view pattern = req->getMatchedPathPattern();
+    for (const auto& route : kRoutes) {
+        if (route.pattern == pattern && (route.method == Invalid || route.method == req->method())) {
+            workload = route.workload;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkloadGate::install() {
+    std::weak_ptr<WorkloadGate> weak = shared_from_this();
+    app().registerPreHandlingAdvice(
+        [weak](const HttpRequestPtr& req, std::function<void(const HttpResponsePtr&)>&& callback,
+               std::function<void()>&& next) {
+            if (auto self = weak.lock()) {
+                self->admit(req, std::move(callback), std::move(next));
+            } else {
+                next();
+            }
+        });
+    app().registerPostHandlingAdvice([weak](const HttpRequestPtr& req, const HttpResponsePtr&) {
+        if (auto self = weak.lock()) self->release(req);
+    });
+}
+
+void WorkloadGate::admit(const HttpRequestPtr& req,
+                         std::function<void(const HttpResponsePtr&)>&& callback, Next&& next) {
+    Workload workload;
+    const auto settings = currentSettings();
+    if (!settings || !classify(req, workload)) {
+        next();
+        return;
+    }
+    const WorkloadLimits& limits = limitsOf(*settings, workload);
+    Class& cls = classes_[static_cast<size_t>(workload)];
+
+    {
+        std::lock_guard<std::mutex> lock(cls.mutex);
+        if (cls.active < limits.concurrency) {
+            ++cls.active;
+        } else if (cls.waiting.size() < limits.queue) {
+            req->attributes()->insert(kWorkloadAttribute, workload);
+            cls.waiting.push_back(Waiter{req->getConnectionPtr(), std::move(next)});
+            return;
+        } else {
+            cls.rejected.fetch_add(1, std::memory_order_relaxed);
+            sendBusy(callback, workload);
+            return;
+        }
+    }
+    req->attributes()->insert(kWorkloadAttribute, workload);
+    cls.admitted.fetch_add(1, std::memory_order_relaxed);
+    next();
+}
+
+// Освобождение места и запуск ожидающих запросов (в потоке их соединений)
+void WorkloadGate::release(const HttpRequestPtr& req) {
+    const auto& attributes = req->attributes();
+    if (!attributes->find(kWorkloadAttribute)) return;
+    const Workload workload = attributes->get<Workload>(kWorkloadAttribute);
+    attributes->erase(kWorkloadAttribute);
+
+    const auto settings = currentSettings();
+    const size_t concurrency = settings ? limitsOf(*settings, workload).concurrency : 0;
+    Class& cls = classes_[static_cast<size_t>(workload)];
+
+    std::vector<std::pair<trantor::TcpConnectionPtr, Next>> ready;
+    {
+        std::lock_guard<std::mutex> lock(cls.mutex);
+        --cls.active;
+        while (cls.active < concurrency && !cls.waiting.empty()) {
+            Waiter waiter = std::move(cls.waiting.front());
+            cls.waiting.pop_front();
+            auto connection = waiter.connection.lock();
+            if (!connection || !connection->connected()) {
+                cls.abandoned.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            ++cls.active;
+            ready.emplace_back(std::move(connection), std::move(waiter.next));
+        }
+    }
+    for (auto& [connection, next] : ready) {
+        cls.admitted.fetch_add(1, std::memory_order_relaxed);
+        cls.delayed.fetch_add(1, std::memory_order_relaxed);
+        connection->getLoop()->queueInLoop(std::move(next));
+    }
+}
+
+Json::Value WorkloadGate::metrics() const {
+    Json::Value result;
+    const auto settings = currentSettings();
+    for (size_t i = 0; i < kWorkloadCount; ++i) {
+        const Workload workload = static_cast<Workload>(i);
+        const Class& cls = classes_[i];
+        Json::Value entry;
+        if (settings) {
+            const WorkloadLimits& limits = limitsOf(*settings, workload);
+            entry["concurrency"] = static_cast<Json::UInt64>(limits.concurrency);
+            entry["queue_limit"] = static_cast<Json::UInt64>(limits.queue);
+            entry["connections"] = static_cast<Json::UInt64>(limits.connections);
+            entry["timeout_ms"] = static_cast<Json::Int64>(limits.timeout.count());
+        }
+        {
+            std::lock_guard<std::mutex> lock(cls.mutex);
+            entry["active"] = static_cast<Json::UInt64>(cls.active);
+            entry["queued"] = static_cast<Json::UInt64>(cls.waiting.size());
+        }
+        entry["admitted"] = static_cast<Json::UInt64>(cls.admitted.load(std::memory_order_relaxed));
+        entry["delayed"] = static_cast<Json::UInt64>(cls.delayed.load(std::memory_order_relaxed));
+        entry["rejected"] = static_cast<Json::UInt64>(cls.rejected.load(std::memory_order_relaxed));
+        entry["abandoned"] = static_cast<Json::UInt64>(cls.abandoned.load(std::memory_order_relaxed));
+        result[workloadName(workload)] = entry;
+    }
+    return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "workload.h"
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+#include <json/json.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// Допуск запросов по классам нагрузки. Маршрут относится к классу по
+// шаблону пути (таблица в workload_gate.cc); запрос класса выполняется,
+// если занято меньше concurrency мест, иначе ждет в очереди класса, а при
+// заполненной очереди сразу получает 503 с Retry-After. Место
+// освобождается, когда обработчик отдал ответ. Пределы читаются из
+// текущего снимка настроек (меняются без перезапуска).
+// Маршруты без класса (/metrics, пакетные операции со своим пулом)
+// проходят без ограничений.
+class WorkloadGate : public std::enable_shared_from_this<WorkloadGate> {
+public:
+    WorkloadGate() = default;
+
+    WorkloadGate(const WorkloadGate&) = delete;
+    WorkloadGate& operator=(const WorkloadGate&) = delete;
+
+    // Регистрация обработчиков Drogon (до app().run())
+    void install();
+
+    // Класс маршрута; false — маршрут не ограничивается
+    static bool classify(const drogon::HttpRequestPtr& req, Workload& workload);
+
+    // Занятость, очереди и отказы по классам (для /metrics)
+    Json::Value metrics() const;
+
+private:
+    using Next = std::function<void()>;
+
+    // Запрос, ожидающий места
+    struct Waiter {
+        std::weak_ptr<trantor::TcpConnection> connection;  // Соединение клиента
+        Next next;                                          // Продолжение обработки
+    };
+
+    struct Class {
+        mutable std::mutex mutex;
+        size_t active = 0;             // Выполняющиеся запросы
+        std::deque<Waiter> waiting;    // Очередь ожидания
+
+        std::atomic<uint64_t> admitted{0};   // Допущенные запросы
+        std::atomic<uint64_t> delayed{0};    // Допущенные после ожидания
+        std::atomic<uint64_t> rejected{0};   // Отказы (очередь заполнена)
+        std::atomic<uint64_t> abandoned{0};  // Клиент закрыл соединение в очереди
+    };
+
+    void admit(const drogon::HttpRequestPtr& req,
+               std::function<void(const drogon::HttpResponsePtr&)>&& callback, Next&& next);
+    void release(const drogon::HttpRequestPtr& req);
+
+    std::array<Class, kWorkloadCount> classes_;
+};
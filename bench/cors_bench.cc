@@ -0,0 +1,83 @@
+// Бенчмарк обработки CORS и заголовков безопасности на ответ: прежний
+// путь (regex_replace и компиляция std::regex на каждый шаблон при каждом
+// ответе) против политики, собранной при загрузке конфигурации.
+#include "../app_config/security_policy.h"
+#include <json/json.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Headers = std::vector<std::pair<std::string, std::string>>;
+
+// Прежний обработчик (app_config.cc до замены)
+void legacyAdvice(const Json::Value& allowed, const std::string& origin, Headers& resp) {
+    if (origin.empty()) return;
+    for (const auto& pattern : allowed) {
+        std::string regexStr = std::regex_replace(pattern.asString(), std::regex("\\*"), ".*");
+        std::regex re("^" + regexStr + "$", std::regex::icase);
+        if (std::regex_match(origin, re)) {
+            resp.emplace_back("Access-Control-Allow-Origin", origin);
+            resp.emplace_back("Vary", "Origin");
+            break;
+        }
+    }
+    resp.emplace_back("X-Content-Type-Options", "nosniff");
+    resp.emplace_back("X-Frame-Options", "DENY");
+    resp.emplace_back("X-XSS-Protection", "1; mode=block");
+}
+
+// Новый обработчик
+void policyAdvice(const SecurityPolicy& policy, const std::string& origin, Headers& resp) {
+    if (!origin.empty() && policy.allowOrigin(origin)) {
+        resp.emplace_back("Access-Control-Allow-Origin", origin);
+        resp.emplace_back("Vary", "Origin");
+    }
+    for (const auto& header : policy.staticHeaders()) resp.push_back(header);
+}
+
+double nsPerOp(int rounds, const std::function<void()>& op) {
+    op(); // Прогрев
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) op();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    // Шаблоны из build/config.json
+    const std::vector<std::string> patterns = {
+        "http://localhost:*", "http://127.0.0.1:*", "http://192.168.1.*"
+    };
+    Json::Value allowed;
+    for (const auto& pattern : patterns) allowed.append(pattern);
+    const SecurityPolicy policy(patterns);
+
+    const std::pair<const char*, std::string> cases[] = {
+        {"no Origin", ""},
+        {"allowed (1st)", "http://localhost:3000"},
+        {"allowed (3rd)", "http://192.168.1.20"},
+        {"rejected", "https://evil.example.com"},
+    };
+
+    std::printf("%-16s %16s %16s\n", "origin", "regex ns/resp", "policy ns/resp");
+    for (const auto& item : cases) {
+        Headers resp;
+        resp.reserve(8);
+        const double legacy = nsPerOp(rounds, [&] { resp.clear(); legacyAdvice(allowed, item.second, resp); });
+        const double compiled = nsPerOp(rounds * 50, [&] { resp.clear(); policyAdvice(policy, item.second, resp); });
+        std::printf("%-16s %16.0f %16.0f\n", item.first, legacy, compiled);
+    }
+    return 0;
+}
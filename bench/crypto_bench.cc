@@ -0,0 +1,197 @@
+// Бенчмарк криптографических путей записи автомобиля: операции в секунду
+// и выделения памяти на операцию. Прежняя схема (контекст EVP и векторы
+// на каждый вызов) сравнивается со слоем crypto_engine (контексты потока,
+// буферы на стеке, алгоритмы запрошены один раз).
+#include "../crypto/crypto_engine.h"
+#include "../storage/car_record_format.h"
+#include "../struct_data/car_struct.h"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <zlib.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Счетчик выделений: operator new и аллокатор OpenSSL
+std::atomic<size_t> allocations{0};
+
+void* countingMalloc(size_t size, const char*, int) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+void* countingRealloc(void* ptr, size_t size, const char*, int) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::realloc(ptr, size);
+}
+
+void countingFree(void* ptr, const char*, int) {
+    std::free(ptr);
+}
+
+} // namespace
+
+// Все замененные формы new/delete идут через одну пару функций: так
+// пары выделения и освобождения согласованы (и для -Wmismatched-new-delete)
+namespace {
+
+[[gnu::noinline]] void* countedAllocate(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void countedRelease(void* ptr) noexcept { std::free(ptr); }
+
+} // namespace
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void operator delete(void* ptr) noexcept { countedRelease(ptr); }
+void operator delete[](void* ptr) noexcept { countedRelease(ptr); }
+void operator delete(void* ptr, size_t) noexcept { countedRelease(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { countedRelease(ptr); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using CipherCtx = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+
+struct Result {
+    double opsPerSec;
+    double allocsPerOp;
+};
+
+// Прогрев (контексты потока, ленивые структуры OpenSSL) и замер
+Result measure(int rounds, const std::function<void()>& op) {
+    for (int i = 0; i < 100; ++i) op();
+
+    const size_t before = allocations.load();
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) op();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    const size_t count = allocations.load() - before;
+    return {rounds / elapsed.count(), static_cast<double>(count) / rounds};
+}
+
+void report(const char* name, const Result& legacy, const Result& engine) {
+    std::printf("%-16s %14.0f %8.1f   %14.0f %8.1f\n", name,
+                legacy.opsPerSec, legacy.allocsPerOp, engine.opsPerSec, engine.allocsPerOp);
+}
+
+// Прежняя схема: SHA-256 с новым контекстом и вектором результата
+std::vector<unsigned char> legacySha256(const CarDetails& data) {
+    std::vector<unsigned char> hash(32);
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(ctx, &data, sizeof(data));
+    EVP_DigestFinal_ex(ctx, hash.data(), nullptr);
+    EVP_MD_CTX_free(ctx);
+    return hash;
+}
+
+// Прежняя схема: шифрование AES-256-CBC с векторами IV и шифртекста
+std::vector<unsigned char> legacyEncrypt(const unsigned char* key, const CarDetails& data) {
+    std::vector<unsigned char> iv(16);
+    RAND_bytes(iv.data(), iv.size());
+    CipherCtx ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    std::vector<unsigned char> out(sizeof(data) + 16);
+    int len = 0, total = 0;
+    EVP_EncryptInit_ex(ctx.get(), EVP_aes_256_cbc(), nullptr, key, iv.data());
+    EVP_EncryptUpdate(ctx.get(), out.data(), &len,
+                      reinterpret_cast<const unsigned char*>(&data), sizeof(data));
+    total = len;
+    EVP_EncryptFinal_ex(ctx.get(), out.data() + total, &len);
+    out.resize(total + len);
+    out.insert(out.begin(), iv.begin(), iv.end());
+    return out;
+}
+
+// Прежняя схема: расшифровка AES-256-CBC с новым контекстом
+CarDetails legacyDecrypt(const unsigned char* key, const std::vector<unsigned char>& file) {
+    std::vector<unsigned char> iv(file.begin(), file.begin() + 16);
+    std::vector<unsigned char> ciphertext(file.begin() + 16, file.end());
+    CipherCtx ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    CarDetails plain;
+    int len = 0, total = 0;
+    EVP_DecryptInit_ex(ctx.get(), EVP_aes_256_cbc(), nullptr, key, iv.data());
+    EVP_DecryptUpdate(ctx.get(), reinterpret_cast<unsigned char*>(&plain), &len,
+                      ciphertext.data(), ciphertext.size());
+    total = len;
+    if (EVP_DecryptFinal_ex(ctx.get(), reinterpret_cast<unsigned char*>(&plain) + total, &len) != 1) {
+        throw std::runtime_error("Decryption finalization failed");
+    }
+    return plain;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Перехват аллокатора OpenSSL до первого выделения
+    CRYPTO_set_mem_functions(countingMalloc, countingRealloc, countingFree);
+
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    unsigned char key[crypto_engine::kKeySize];
+    RAND_bytes(key, sizeof(key));
+    CarDetails details{};
+    std::snprintf(details.vin, sizeof(details.vin), "%s", "1HGCM82633A004352");
+
+    const auto legacyFile = legacyEncrypt(key, details);
+    car_record::Record record;
+    car_record::seal(details, key, 100000, record);
+
+    std::printf("rounds: %d\n", rounds);
+    std::printf("%-16s %14s %8s   %14s %8s\n", "path",
+                "legacy op/s", "alloc", "engine op/s", "alloc");
+
+    // Шифрование: CBC с векторами против GCM-записи с контекстом потока
+    report("encrypt",
+        measure(rounds, [&] { legacyEncrypt(key, details); }),
+        measure(rounds, [&] { car_record::seal(details, key, 100000, record); }));
+
+    // Расшифровка записи текущего формата
+    report("decrypt",
+        measure(rounds, [&] { legacyDecrypt(key, legacyFile); }),
+        measure(rounds, [&] {
+            CarDetails out;
+            car_record::open(record.data(), record.size(), key, out);
+        }));
+
+    // Расшифровка старого формата (путь миграции)
+    report("decrypt-cbc",
+        measure(rounds, [&] { legacyDecrypt(key, legacyFile); }),
+        measure(rounds, [&] {
+            unsigned char plain[sizeof(CarDetails) + 2 * crypto_engine::kBlockSize];
+            crypto_engine::cbcDecrypt(key, legacyFile.data(), legacyFile.data() + 16,
+                                      legacyFile.size() - 16, plain, sizeof(plain));
+        }));
+
+    report("sha256",
+        measure(rounds, [&] { legacySha256(details); }),
+        measure(rounds, [&] {
+            unsigned char hash[crypto_engine::kSha256Size];
+            crypto_engine::sha256(&details, sizeof(details), hash);
+        }));
+
+    report("crc32",
+        measure(rounds, [&] {
+            volatile uLong crc = ::crc32(0, reinterpret_cast<const Bytef*>(&details), sizeof(details));
+            (void)crc;
+        }),
+        measure(rounds, [&] {
+            volatile uint32_t crc = crypto_engine::crc32(&details, sizeof(details));
+            (void)crc;
+        }));
+    return 0;
+}
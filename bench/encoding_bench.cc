@@ -0,0 +1,112 @@
+// Бенчмарк двоичных представлений отчетов: размер тела (без сжатия и
+// после gzip) и время кодирования. CBOR и MessagePack строятся из текста
+// столбца напрямую (transcodeJson), для сравнения — прежний путь JSON
+// через Json::Value (разбор и повторная сериализация).
+#include "../utilities/json_transcoder.h"
+#include <json/json.h>
+#include <zlib.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Ежедневный отчет: по записи на узел с числовыми показателями
+std::string makeDailyReport(size_t nodes) {
+    std::string text = "{\"date\":\"2024-03-15\",\"nodes\":[";
+    for (size_t node = 0; node < nodes; ++node) {
+        if (node) text += ',';
+        text += "{\"node_name\":\"Узел " + std::to_string(node)
+              + "\",\"mileage_km\":" + std::to_string(120000 + node * 37)
+              + ",\"engine_hours\":" + std::to_string(3400 + node) + ".5"
+              + ",\"avg_speed\":" + std::to_string(40 + node % 30) + ".75"
+              + ",\"max_temp\":" + std::to_string(80 + node % 15)
+              + ",\"fuel_l\":" + std::to_string(12 + node % 9) + ".125"
+              + ",\"errors\":" + std::to_string(node % 3)
+              + ",\"ok\":" + (node % 5 ? "true" : "false") + "}";
+    }
+    text += "]}";
+    return text;
+}
+
+// Отчет за период: узлы, подузлы, замеры по дням
+std::string makePeriodReport(size_t targetBytes) {
+    std::string text = "{\"period\":{\"start\":\"2024-01-01\",\"end\":\"2024-12-31\"},\"nodes\":[";
+    for (size_t node = 0; text.size() < targetBytes; ++node) {
+        if (node) text += ',';
+        text += "{\"node_name\":\"Узел " + std::to_string(node) + "\",\"subnodes\":[";
+        for (int sub = 0; sub < 8; ++sub) {
+            if (sub) text += ',';
+            text += "{\"name\":\"Подузел " + std::to_string(sub) + "\",\"measurements\":[";
+            for (int m = 0; m < 6; ++m) {
+                if (m) text += ',';
+                text += "{\"date\":\"2024-03-" + std::to_string(10 + m)
+                      + "\",\"value\":" + std::to_string(node * 31 + sub * 7 + m)
+                      + ".25,\"status\":\"ok\"}";
+            }
+            text += "]}";
+        }
+        text += "]}";
+    }
+    text += "]}";
+    return text;
+}
+
+// Размер после gzip (уровень по умолчанию, как у Drogon)
+size_t gzipSize(const std::string& data) {
+    uLongf size = compressBound(static_cast<uLong>(data.size()));
+    std::string out(size, '\0');
+    compress2(reinterpret_cast<Bytef*>(&out[0]), &size,
+              reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()),
+              Z_DEFAULT_COMPRESSION);
+    return size;
+}
+
+double measure(int rounds, const std::function<void()>& op) {
+    op(); // Прогрев
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) op();
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+void run(const char* name, const std::string& json, int rounds) {
+    Json::CharReaderBuilder readerBuilder;
+    std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+    Json::StreamWriterBuilder writer;
+    writer.settings_["emitUTF8"] = true;
+    writer.settings_["indentation"] = "";
+
+    std::string cbor, msgpack;
+    const double jsonMs = measure(rounds, [&] {
+        Json::Value value;
+        std::string errors;
+        reader->parse(json.data(), json.data() + json.size(), &value, &errors);
+        std::string body = Json::writeString(writer, value);
+    });
+    const double cborMs = measure(rounds, [&] { transcodeJson(json, BinaryFormat::Cbor, cbor); });
+    const double msgpackMs = measure(rounds, [&] { transcodeJson(json, BinaryFormat::MsgPack, msgpack); });
+
+    std::printf("\n%s (%d rounds)\n", name, rounds);
+    std::printf("%-20s %12s %12s %12s\n", "encoding", "bytes", "gzip bytes", "ms/op");
+    std::printf("%-20s %12zu %12zu %12.3f\n", "json (parse+write)", json.size(), gzipSize(json), jsonMs);
+    std::printf("%-20s %12zu %12zu %12.3f\n", "cbor", cbor.size(), gzipSize(cbor), cborMs);
+    std::printf("%-20s %12zu %12zu %12.3f\n", "msgpack", msgpack.size(), gzipSize(msgpack), msgpackMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t nodes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    const size_t megabytes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    const int rounds = argc > 3 ? std::atoi(argv[3]) : 20;
+
+    run("daily report", makeDailyReport(nodes), rounds * 50);
+    run("period report", makePeriodReport(megabytes * 1024 * 1024), rounds);
+    return 0;
+}
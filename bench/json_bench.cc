@@ -0,0 +1,130 @@
+// Бенчмарк выдачи отчета, сформированного PostgreSQL: разбор в Json::Value
+// и повторная сериализация (прежний путь контроллеров) против передачи
+// текста столбца в тело ответа как есть (newRawJsonResponse).
+// Помимо времени измеряется пиковый объем памяти, выделенной за операцию.
+#include <json/json.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace {
+
+// Учет живых и пиковых байт: размер хранится перед блоком
+constexpr size_t kHeader = alignof(std::max_align_t);
+std::atomic<size_t> liveBytes{0};
+std::atomic<size_t> peakBytes{0};
+
+void* trackedAlloc(size_t size) {
+    auto* block = static_cast<unsigned char*>(std::malloc(size + kHeader));
+    if (!block) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(block) = size;
+    size_t live = liveBytes.fetch_add(size) + size;
+    size_t peak = peakBytes.load();
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live)) {}
+    return block + kHeader;
+}
+
+void trackedFree(void* ptr) {
+    if (!ptr) return;
+    auto* block = static_cast<unsigned char*>(ptr) - kHeader;
+    liveBytes.fetch_sub(*reinterpret_cast<size_t*>(block));
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return trackedAlloc(size); }
+void* operator new[](size_t size) { return trackedAlloc(size); }
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Отчет за период в форме, близкой к get_period_report: узлы, подузлы, замеры
+std::string makeReport(size_t targetBytes) {
+    std::string text = "{\"period\":{\"start\":\"2024-01-01\",\"end\":\"2024-12-31\"},\"nodes\":[";
+    for (size_t node = 0; text.size() < targetBytes; ++node) {
+        if (node) text += ',';
+        text += "{\"node_name\":\"Узел " + std::to_string(node) + "\",\"subnodes\":[";
+        for (int sub = 0; sub < 8; ++sub) {
+            if (sub) text += ',';
+            text += "{\"name\":\"Подузел " + std::to_string(sub) + "\",\"measurements\":[";
+            for (int m = 0; m < 6; ++m) {
+                if (m) text += ',';
+                text += "{\"date\":\"2024-03-" + std::to_string(10 + m)
+                      + "\",\"value\":" + std::to_string(node * 31 + sub * 7 + m)
+                      + ".25,\"status\":\"ok\"}";
+            }
+            text += "]}";
+        }
+        text += "]}";
+    }
+    text += "]}";
+    return text;
+}
+
+struct Result {
+    double msPerOp;
+    double peakMb;
+};
+
+Result measure(int rounds, const std::function<void()>& op) {
+    op(); // Прогрев
+
+    const size_t base = liveBytes.load();
+    peakBytes = base;
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) op();
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    return {elapsed.count() / rounds, (peakBytes.load() - base) / (1024.0 * 1024.0)};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    const std::string column = makeReport(megabytes * 1024 * 1024);
+    const double sizeMb = column.size() / (1024.0 * 1024.0);
+
+    Json::CharReaderBuilder readerBuilder;
+    std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+    Json::StreamWriterBuilder writer;
+    writer.settings_["emitUTF8"] = true;
+    writer.settings_["indentation"] = "";
+
+    // Прежний путь: as<Json::Value>() + Json::writeString
+    Result dom = measure(rounds, [&] {
+        Json::Value report;
+        std::string errors;
+        if (!reader->parse(column.data(), column.data() + column.size(), &report, &errors)) {
+            std::fprintf(stderr, "parse error: %s\n", errors.c_str());
+            std::exit(EXIT_FAILURE);
+        }
+        std::string body = Json::writeString(writer, report);
+    });
+
+    // Сквозная передача: одно копирование байтов столбца в тело ответа
+    Result raw = measure(rounds, [&] {
+        std::string body(column.data(), column.size());
+    });
+
+    std::printf("report size: %.1f MB, rounds: %d\n", sizeMb, rounds);
+    std::printf("%-14s %12s %12s %12s\n", "path", "ms/op", "MB/s", "peak MB");
+    std::printf("%-14s %12.2f %12.0f %12.1f\n", "parse+write", dom.msPerOp,
+                sizeMb / dom.msPerOp * 1000, dom.peakMb);
+    std::printf("%-14s %12.2f %12.0f %12.1f\n", "passthrough", raw.msPerOp,
+                sizeMb / raw.msPerOp * 1000, raw.peakMb);
+    return 0;
+}
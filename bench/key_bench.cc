@@ -0,0 +1,98 @@
+// Бенчмарк стоимости расшифровки записи автомобиля на один запрос:
+// вывод ключа PBKDF2 на каждый вызов (прежняя схема) против резидентного
+// ключа KeyManager.
+#include "../crypto/key_manager.h"
+#include "../struct_data/car_struct.h"
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Шифрование структуры AES-256-CBC (подготовка входных данных)
+std::vector<unsigned char> encrypt(const unsigned char* key, const unsigned char* iv,
+                                   const CarDetails& data) {
+    std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)> ctx(
+        EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    std::vector<unsigned char> out(sizeof(data) + 16);
+    int len = 0, total = 0;
+    EVP_EncryptInit_ex(ctx.get(), EVP_aes_256_cbc(), nullptr, key, iv);
+    EVP_EncryptUpdate(ctx.get(), out.data(), &len,
+                      reinterpret_cast<const unsigned char*>(&data), sizeof(data));
+    total = len;
+    EVP_EncryptFinal_ex(ctx.get(), out.data() + total, &len);
+    out.resize(total + len);
+    return out;
+}
+
+// Расшифровка, повторяющая путь GET /car/info
+CarDetails decrypt(const unsigned char* key, const unsigned char* iv,
+                   const std::vector<unsigned char>& ciphertext) {
+    std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)> ctx(
+        EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    CarDetails plain;
+    int len = 0, total = 0;
+    EVP_DecryptInit_ex(ctx.get(), EVP_aes_256_cbc(), nullptr, key, iv);
+    EVP_DecryptUpdate(ctx.get(), reinterpret_cast<unsigned char*>(&plain), &len,
+                      ciphertext.data(), ciphertext.size());
+    total = len;
+    if (EVP_DecryptFinal_ex(ctx.get(), reinterpret_cast<unsigned char*>(&plain) + total, &len) != 1) {
+        throw std::runtime_error("Decryption finalization failed");
+    }
+    return plain;
+}
+
+// Среднее время одной операции в микросекундах
+double measure(int rounds, const std::function<void()>& op) {
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) op();
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const std::string secret = "bench_key";
+    const std::string salt = "bench_salt";
+
+    KeyManager keys(secret, salt, iterations);
+
+    unsigned char iv[16];
+    RAND_bytes(iv, sizeof(iv));
+    CarDetails details;
+    auto ciphertext = keys.withKey([&](const unsigned char* key) {
+        return encrypt(key, iv, details);
+    });
+
+    // Прежняя схема: PBKDF2 на каждый запрос
+    double perRequestKdf = measure(20, [&] {
+        unsigned char key[KeyManager::kKeySize];
+        PKCS5_PBKDF2_HMAC(secret.c_str(), secret.size(),
+                          reinterpret_cast<const unsigned char*>(salt.c_str()), salt.size(),
+                          iterations, EVP_sha256(), sizeof(key), key);
+        decrypt(key, iv, ciphertext);
+    });
+
+    // Новая схема: ключ выведен один раз при старте
+    double residentKey = measure(200000, [&] {
+        keys.withKey([&](const unsigned char* key) {
+            return decrypt(key, iv, ciphertext);
+        });
+    });
+
+    std::printf("PBKDF2 iterations:        %d\n", iterations);
+    std::printf("per-request KDF + decrypt: %12.2f us/op\n", perRequestKdf);
+    std::printf("resident key + decrypt:    %12.2f us/op\n", residentKey);
+    std::printf("speedup:                   %12.0fx\n", perRequestKdf / residentKey);
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "body_encoding.h"
+#include "../utilities/utilities.h"
+#include <brotli/encode.h>
+#include <zlib.h>
+#include <cstdlib>
+
+namespace {
+// Уровни сжатия: вариант сжимается один раз на отчет, поэтому выше умолчаний
+constexpr int kGzipLevel = 9;
+constexpr int kBrotliQuality = 9;
+}
+
+// Сжатие gzip (zlib с заголовком gzip)
+std::string gzipCompress(std::string_view data) {
+    z_stream stream{};
+    if (deflateInit2(&stream, kGzipLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return std::string();
+    }
+
+    std::string out;
+    out.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+
+    const int rc = deflate(&stream, Z_FINISH);
+    const size_t written = stream.total_out;
+    deflateEnd(&stream);
+    if (rc != Z_STREAM_END) return std::string();
+
+    out.resize(written);
+    return out;
+}
+
+// Сжатие brotli (однопроходное, окно по умолчанию)
+std::string brotliCompress(std::string_view data) {
+    size_t size = BrotliEncoderMaxCompressedSize(data.size());
+    if (size == 0) return std::string();
+
+    std::string out(size, '\0');
+    if (!BrotliEncoderCompress(kBrotliQuality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               data.size(), reinterpret_cast<const uint8_t*>(data.data()),
+                               &size, reinterpret_cast<uint8_t*>(&out[0]))) {
+        return std::string();
+    }
+    out.resize(size);
+    return out;
+}
+
+// Разбор Accept-Encoding: "br;q=1.0, gzip;q=0.8, *;q=0"
+BodyEncoding pickEncoding(std::string_view acceptEncoding, bool haveGzip, bool haveBrotli) {
+    double gzipQ = 0, brotliQ = 0, anyQ = -1;
+    bool gzipListed = false, brotliListed = false;
+
+    while (!acceptEncoding.empty()) {
+        const size_t comma = acceptEncoding.find(',');
+        std::string_view item = acceptEncoding.substr(0, comma);
+        acceptEncoding = comma == std::string_view::npos ? std::string_view()
+                                                         : acceptEncoding.substr(comma + 1);
+
+        double q = 1.0;
+        const size_t semicolon = item.find(';');
+        if (semicolon != std::string_view::npos) {
+            std::string_view param = trimView(item.substr(semicolon + 1));
+            if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+                q = std::strtod(std::string(param.substr(2)).c_str(), nullptr);
+            }
+            item = item.substr(0, semicolon);
+        }
+        item = trimView(item);
+
+        if (equalsIgnoreCase(item, "gzip")) {
+            gzipQ = q;
+            gzipListed = true;
+        } else if (equalsIgnoreCase(item, "br")) {
+            brotliQ = q;
+            brotliListed = true;
+        } else if (item == "*") {
+            anyQ = q;
+        }
+    }
+
+    // "*" распространяется на не перечисленные явно кодировки
+    if (anyQ >= 0) {
+        if (!gzipListed) gzipQ = anyQ;
+        if (!brotliListed) brotliQ = anyQ;
+    }
+    if (!haveGzip) gzipQ = 0;
+    if (!haveBrotli) brotliQ = 0;
+
+    // При равных весах brotli предпочтительнее (меньше объем)
+    if (brotliQ > 0 && brotliQ >= gzipQ) return BodyEncoding::Brotli;
+    if (gzipQ > 0) return BodyEncoding::Gzip;
+    return BodyEncoding::Identity;
+}
+
+// Имя кодировки для Content-Encoding
+const char* encodingName(BodyEncoding encoding) {
+    switch (encoding) {
+    case BodyEncoding::Gzip: return "gzip";
+    case BodyEncoding::Brotli: return "br";
+    default: return nullptr;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Кодировки тела ответа (Content-Encoding)
+enum class BodyEncoding { Identity, Gzip, Brotli };
+
+// Минимальный размер тела для сжатия (как у Drogon: меньшие тела не сжимаются)
+constexpr size_t kMinCompressSize = 1024;
+
+// Сжатие gzip; пустая строка — ошибка
+std::string gzipCompress(std::string_view data);
+
+// Сжатие brotli; пустая строка — ошибка
+std::string brotliCompress(std::string_view data);
+
+// Выбор кодировки по Accept-Encoding (с учетом q-значений) среди доступных
+BodyEncoding pickEncoding(std::string_view acceptEncoding, bool haveGzip, bool haveBrotli);
+
+// Значение заголовка Content-Encoding (nullptr — без сжатия)
+const char* encodingName(BodyEncoding encoding);
@@ -0,0 +1,150 @@
+#include "report_fetcher.h"
+#include "body_encoding.h"
+#include <json/json.h>
+
+using namespace drogon;
+
+// Регистрация ожидающего; не nullptr — запрос к БД нужно выполнить этому
+// вызову. К запросу, начатому до инвалидации группы, новый клиент не
+// присоединяется: его результат может не учитывать изменение.
+ReportFetcher::FlightPtr ReportFetcher::join(const ReportQuery& query, Waiter&& waiter) {
+    const uint64_t generation = query.tag.empty() ? 0 : cache_->generation(query.tag);
+
+    std::lock_guard<std::mutex> lock(inflightMutex_);
+    auto& flight = inflight_[query.key];
+    if (flight && flight->generation == generation) {
+        flight->waiters.push_back(std::move(waiter));
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    flight = std::make_shared<Flight>();
+    flight->generation = generation;
+    flight->waiters.push_back(std::move(waiter));
+    started_.fetch_add(1, std::memory_order_relaxed);
+    return flight;
+}
+
+// Разбор результата запроса
+void ReportFetcher::onResult(const ReportQuery& query, const FlightPtr& flight,
+                             const orm::Result& result) {
+    if (result.empty()) {
+        complete(query, *flight, Outcome{Outcome::NotFound, nullptr});
+        return;
+    }
+
+    const auto& field = result[0][query.column];
+    auto body = std::make_shared<CachedBody>();
+    body->body = rawJson(field);
+
+    // Отсутствие данных не кэшируется: они могут появиться позже
+    if (field.isNull() || !query.cacheable) {
+        complete(query, *flight, Outcome{Outcome::Body, std::move(body)});
+        return;
+    }
+
+    // Ожидающие получают несжатое тело сразу; варианты gzip и brotli
+    // строятся в пуле и добавляются к записи кэша для следующих запросов
+    auto stored = store(query, *flight, std::move(body));
+    if (stored->body.size() >= kMinCompressSize && stored->gzip.empty() && stored->brotli.empty()) {
+        // Очередь пула заполнена: запись остается без сжатых вариантов
+        compressor_->trySubmit([cache = cache_, key = query.key, stored]() {
+            auto compressed = std::make_shared<CachedBody>();
+            compressed->body = stored->body;
+            compressed->gzip = gzipCompress(stored->body);
+            compressed->brotli = brotliCompress(stored->body);
+            cache->replace(key, stored, std::move(compressed));
+        });
+    }
+}
+
+// Сохранение в кэш и ответ ожидающим. Запись в кэш выполнена до снятия
+// ключа, поэтому новый запрос либо присоединится, либо попадет в кэш.
+// Если группа инвалидирована после старта запроса, кэш тело не сохраняет.
+// Возвращает тело, отправленное ожидающим.
+std::shared_ptr<const CachedBody> ReportFetcher::store(const ReportQuery& query, Flight& flight,
+                                                       std::shared_ptr<const CachedBody> body) {
+    const auto ttl = query.immutable ? ResponseCache::kImmutable : ttl_;
+    auto stored = cache_->put(query.key, std::move(body), ttl, query.tag, flight.generation);
+    complete(query, flight, Outcome{Outcome::Body, stored});
+    return stored;
+}
+
+// Ответ всем ожидающим запроса
+void ReportFetcher::complete(const ReportQuery& query, Flight& flight, const Outcome& outcome) {
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex_);
+        waiters.swap(flight.waiters);
+        auto found = inflight_.find(query.key);
+        if (found != inflight_.end() && found->second.get() == &flight) inflight_.erase(found);
+    }
+
+    // Каждому клиенту — собственный объект ответа (заголовки дополняются после обработчика)
+    for (auto& waiter : waiters) {
+        waiter.callback(makeResponse(query, outcome, waiter));
+    }
+}
+
+// Построение ответа по результату
+HttpResponsePtr ReportFetcher::makeResponse(const ReportQuery& query, const Outcome& outcome,
+                                            const Waiter& waiter) {
+    switch (outcome.kind) {
+    case Outcome::Body:
+        return makeBodyResponse(*outcome.body, waiter.acceptEncoding, waiter.format);
+    case Outcome::NotFound: {
+        Json::Value error;
+        error["error"] = query.notFound;
+        return HttpResponse::newHttpJsonResponse(error);
+    }
+    case Outcome::DbError:
+    default: {
+        Json::Value errorResp;
+        errorResp["error"] = query.dbError;
+        auto resp = HttpResponse::newHttpJsonResponse(errorResp);
+        resp->setStatusCode(k500InternalServerError);
+        return resp;
+    }
+    }
+}
+
+// Ответ с телом в кодировке, выбранной по Accept-Encoding. Для ответа
+// с Content-Encoding Drogon повторно тело не сжимает. Двоичные форматы
+// (CBOR / MessagePack) строятся из JSON на каждый запрос.
+HttpResponsePtr ReportFetcher::makeBodyResponse(const CachedBody& body,
+                                                const std::string& acceptEncoding,
+                                                std::optional<BinaryFormat> format) {
+    HttpResponsePtr resp;
+    BodyEncoding encoding = BodyEncoding::Identity;
+    if (format) {
+        resp = newNegotiatedResponse(std::string(body.body), format);
+    } else {
+        encoding = pickEncoding(acceptEncoding, !body.gzip.empty(), !body.brotli.empty());
+        switch (encoding) {
+        case BodyEncoding::Brotli:
+            resp = newRawJsonResponse(std::string(body.brotli));
+            break;
+        case BodyEncoding::Gzip:
+            resp = newRawJsonResponse(std::string(body.gzip));
+            break;
+        default:
+            resp = newRawJsonResponse(std::string(body.body));
+            break;
+        }
+    }
+    if (const char* name = encodingName(encoding)) {
+        resp->addHeader("Content-Encoding", name);
+    }
+    resp->addHeader("Vary", "Accept, Accept-Encoding");
+    return resp;
+}
+
+// Счетчики объединения запросов
+Json::Value ReportFetcher::metrics() const {
+    Json::Value result;
+    result["started"] = static_cast<Json::UInt64>(started_.load(std::memory_order_relaxed));
+    result["coalesced"] = static_cast<Json::UInt64>(coalesced_.load(std::memory_order_relaxed));
+
+    std::lock_guard<std::mutex> lock(inflightMutex_);
+    result["in_flight"] = static_cast<Json::UInt64>(inflight_.size());
+    return result;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "response_cache.h"
+#include "../db/statement_registry.h"
+#include "../utilities/worker_pool.h"
+#include "../utilities/json_response.h"
+#include <drogon/drogon.h>
+#include <chrono>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Группа кэша отчетов, зависящих от данных ТО (сбрасывается /add-maintenance)
+inline constexpr char kMaintenanceCacheTag[] = "maintenance";
+
+// Параметры выдачи отчета
+struct ReportQuery {
+    StatementId statement;   // Запрос к хранимой функции
+    const char* column;      // Столбец результата с JSON
+    std::string key;         // Нормализованный ключ (эндпоинт + параметры): кэш и объединение
+    bool immutable;          // Отчет за прошедшие даты: без TTL
+    std::string tag;         // Группа инвалидации (пусто — без группы)
+    const char* notFound;    // Сообщение при пустом результате
+    const char* logContext;  // Контекст для журнала ошибок
+    const char* dbError = "Ошибка генерации отчета"; // Сообщение клиенту при ошибке БД
+    bool cacheable = true;   // false — только объединение одновременных запросов
+};
+
+// Выдача отчетов через кэш тел ответов: при попадании ответ строится
+// из кэша без обращения к БД, при промахе результат запроса сохраняется.
+// Одновременные запросы с одинаковым ключом присоединяются к уже
+// выполняющемуся запросу и получают то же тело ответа (single-flight).
+// Запрос, начатый до инвалидации своей группы, не сохраняет результат
+// в кэш, и новые клиенты к нему не присоединяются.
+// Крупные тела отдаются без сжатия сразу, а варианты gzip и brotli строятся
+// один раз в пуле потоков и добавляются к записи кэша; вариант выбирается
+// по Accept-Encoding.
+// По Accept тело перекодируется в CBOR или MessagePack.
+class ReportFetcher : public std::enable_shared_from_this<ReportFetcher> {
+public:
+    using Callback = std::function<void(const drogon::HttpResponsePtr&)>;
+
+    ReportFetcher(std::shared_ptr<StatementRegistry> db,
+                  std::shared_ptr<ResponseCache> cache,
+                  std::shared_ptr<WorkerPool> compressor,
+                  std::chrono::seconds ttl)
+        : db_(std::move(db)), cache_(std::move(cache)),
+          compressor_(std::move(compressor)), ttl_(ttl) {}
+
+    template <typename... Args>
+    void fetch(const ReportQuery& query, const drogon::HttpRequestPtr& req,
+               Callback&& callback, Args&&... args) {
+        const std::string& acceptEncoding = req->getHeader("Accept-Encoding");
+        const auto format = negotiateBinaryFormat(req->getHeader("Accept"));
+        if (query.cacheable) {
+            if (auto cached = cache_->get(query.key)) {
+                callback(makeBodyResponse(*cached, acceptEncoding, format));
+                return;
+            }
+        }
+
+        // Присоединение к выполняющемуся запросу
+        auto flight = join(query, Waiter{std::move(callback), acceptEncoding, format});
+        if (!flight) return;
+
+        db_->execAsync(
+            query.statement,
+            [self = shared_from_this(), query, flight](const drogon::orm::Result& result) {
+                self->onResult(query, flight, result);
+            },
+            [self = shared_from_this(), query, flight](const drogon::orm::DrogonDbException& e) {
+                LOG_ERROR << query.logContext << ": " << e.base().what();
+                self->complete(query, *flight, Outcome{Outcome::DbError, nullptr});
+            },
+            std::forward<Args>(args)...
+        );
+    }
+
+    // Счетчики объединения запросов (для /metrics)
+    Json::Value metrics() const;
+
+private:
+    // Ожидающий ответа клиент
+    struct Waiter {
+        Callback callback;
+        std::string acceptEncoding;
+        std::optional<BinaryFormat> format;  // Формат тела по Accept (nullopt — JSON)
+    };
+
+    // Результат запроса, общий для всех ожидающих
+    struct Outcome {
+        enum Kind { Body, NotFound, DbError } kind;
+        std::shared_ptr<const CachedBody> body;  // Для Body
+    };
+
+    // Выполняющийся запрос
+    struct Flight {
+        uint64_t generation;          // Поколение группы кэша при старте запроса
+        std::vector<Waiter> waiters;  // Первый — инициатор
+    };
+    using FlightPtr = std::shared_ptr<Flight>;
+
+    FlightPtr join(const ReportQuery& query, Waiter&& waiter);
+    void onResult(const ReportQuery& query, const FlightPtr& flight, const drogon::orm::Result& result);
+    std::shared_ptr<const CachedBody> store(const ReportQuery& query, Flight& flight,
+                                            std::shared_ptr<const CachedBody> body);
+    void complete(const ReportQuery& query, Flight& flight, const Outcome& outcome);
+    static drogon::HttpResponsePtr makeResponse(const ReportQuery& query, const Outcome& outcome,
+                                                const Waiter& waiter);
+    static drogon::HttpResponsePtr makeBodyResponse(const CachedBody& body,
+                                                    const std::string& acceptEncoding,
+                                                    std::optional<BinaryFormat> format);
+
+    std::shared_ptr<StatementRegistry> db_;  // Реестр запросов к БД
+    std::shared_ptr<ResponseCache> cache_;   // Кэш тел ответов
+    std::shared_ptr<WorkerPool> compressor_; // Пул для сжатия вариантов (вне IO-потоков)
+    std::chrono::seconds ttl_;               // TTL изменяемых отчетов
+
+    // Выполняющиеся запросы по ключу (запрос, начатый до инвалидации,
+    // заменяется новым, но отвечает своим ожидающим)
+    mutable std::mutex inflightMutex_;
+    std::unordered_map<std::string, FlightPtr> inflight_;
+    std::atomic<uint64_t> started_{0};    // Запросы, ушедшие в БД
+    std::atomic<uint64_t> coalesced_{0};  // Запросы, присоединенные к выполняющимся
+};
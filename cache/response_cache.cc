@@ -0,0 +1,139 @@
+#include "response_cache.h"
+#include <iterator>
+
+namespace {
+// Накладные расходы на запись (узел списка, элемент индекса, управляющий блок)
+constexpr size_t kEntryOverhead = 128;
+
+// Учитываемый объем записи
+size_t entryBytes(const std::string& key, const CachedBody& value, const std::string& tag) {
+    return key.size() * 2 + value.body.size() + value.gzip.size() +
+           value.brotli.size() + tag.size() + kEntryOverhead;
+}
+}
+
+ResponseCache::ResponseCache(size_t capacityBytes) : capacity_(capacityBytes) {}
+
+// Поиск записи с продвижением в начало LRU
+std::shared_ptr<const CachedBody> ResponseCache::get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto it = found->second;
+    if (!it->immutable && Clock::now() >= it->expires) {
+        eraseLocked(it);
+        expirations_.fetch_add(1, std::memory_order_relaxed);
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return it->value;
+}
+
+// Сохранение тела с вытеснением давно не использованных записей
+std::shared_ptr<const CachedBody> ResponseCache::put(const std::string& key,
+                                                     std::shared_ptr<const CachedBody> value,
+                                                     std::chrono::seconds ttl,
+                                                     const std::string& tag,
+                                                     uint64_t generation) {
+    const size_t bytes = entryBytes(key, *value, tag);
+
+    // Запись больше всего кэша не сохраняется
+    if (bytes > capacity_) return value;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!tag.empty()) {
+        auto group = generations_.find(tag);
+        if ((group == generations_.end() ? 0 : group->second) != generation) return value;
+    }
+
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        if (found->second->immutable) return found->second->value;
+        eraseLocked(found->second);
+    }
+
+    while (bytes_ + bytes > capacity_ && !lru_.empty()) {
+        eraseLocked(std::prev(lru_.end()));
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const bool immutable = ttl == kImmutable;
+    lru_.push_front(Node{key, value, immutable ? Clock::time_point::max() : Clock::now() + ttl,
+                         immutable, tag, bytes});
+    index_.emplace(key, lru_.begin());
+    bytes_ += bytes;
+    return value;
+}
+
+// Замена тела записи с пересчетом объема: запись переносится в начало
+// LRU, при превышении предела вытесняются давно не использованные
+void ResponseCache::replace(const std::string& key, const std::shared_ptr<const CachedBody>& expected,
+                            std::shared_ptr<const CachedBody> value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end() || found->second->value != expected) return;
+
+    auto it = found->second;
+    const size_t bytes = entryBytes(key, *value, it->tag);
+    if (bytes > capacity_) return;
+
+    bytes_ = bytes_ - it->bytes + bytes;
+    it->value = std::move(value);
+    it->bytes = bytes;
+    lru_.splice(lru_.begin(), lru_, it);
+    while (bytes_ > capacity_ && lru_.size() > 1) {
+        eraseLocked(std::prev(lru_.end()));
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Инвалидация группы записей
+void ResponseCache::invalidate(const std::string& tag) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generations_[tag];
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        auto next = std::next(it);
+        if (it->tag == tag) {
+            eraseLocked(it);
+            invalidations_.fetch_add(1, std::memory_order_relaxed);
+        }
+        it = next;
+    }
+}
+
+// Поколение группы (0 — группа не инвалидировалась)
+uint64_t ResponseCache::generation(const std::string& tag) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = generations_.find(tag);
+    return found == generations_.end() ? 0 : found->second;
+}
+
+// Удаление записи (под mutex_)
+void ResponseCache::eraseLocked(List::iterator it) {
+    bytes_ -= it->bytes;
+    index_.erase(it->key);
+    lru_.erase(it);
+}
+
+// Счетчики кэша
+Json::Value ResponseCache::metrics() const {
+    Json::Value result;
+    result["hits"] = static_cast<Json::UInt64>(hits_.load(std::memory_order_relaxed));
+    result["misses"] = static_cast<Json::UInt64>(misses_.load(std::memory_order_relaxed));
+    result["evictions"] = static_cast<Json::UInt64>(evictions_.load(std::memory_order_relaxed));
+    result["expirations"] = static_cast<Json::UInt64>(expirations_.load(std::memory_order_relaxed));
+    result["invalidations"] = static_cast<Json::UInt64>(invalidations_.load(std::memory_order_relaxed));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    result["entries"] = static_cast<Json::UInt64>(index_.size());
+    result["bytes"] = static_cast<Json::UInt64>(bytes_);
+    result["capacity_bytes"] = static_cast<Json::UInt64>(capacity_);
+    return result;
+}
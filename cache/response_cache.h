@@ -0,0 +1,92 @@
+#pragma once
+
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Закэшированный ответ отчета: сериализованное тело JSON и его
+// заранее сжатые варианты (пусто — вариант не построен)
+struct CachedBody {
+    std::string body;
+    std::string gzip;
+    std::string brotli;
+};
+
+// Кэш тел ответов с вытеснением по LRU и ограничением объема в байтах.
+// Ключ — нормализованные эндпоинт и параметры. Запись либо живет до
+// истечения TTL, либо неизменна (отчеты за прошедшие даты) и покидает
+// кэш только при вытеснении или явной инвалидации по тегу.
+class ResponseCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // TTL неизменной записи
+    static constexpr std::chrono::seconds kImmutable = std::chrono::seconds::max();
+
+    explicit ResponseCache(size_t capacityBytes);
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // Поиск записи; nullptr — промах (в том числе истекший TTL)
+    std::shared_ptr<const CachedBody> get(const std::string& key);
+
+    // Сохранение тела. Неизменная запись не перезаписывается (возвращается
+    // уже сохраненная). tag — группа для инвалидации (пусто — без группы).
+    // generation — поколение группы на момент начала запроса к БД: если
+    // группа с тех пор инвалидирована, тело не сохраняется (оно могло
+    // быть построено по данным до изменения).
+    std::shared_ptr<const CachedBody> put(const std::string& key,
+                                          std::shared_ptr<const CachedBody> value,
+                                          std::chrono::seconds ttl,
+                                          const std::string& tag = std::string(),
+                                          uint64_t generation = 0);
+
+    // Замена тела записи (например, телом со сжатыми вариантами). Запись
+    // заменяется, только если в ней все еще хранится expected; TTL и
+    // группа сохраняются.
+    void replace(const std::string& key, const std::shared_ptr<const CachedBody>& expected,
+                 std::shared_ptr<const CachedBody> value);
+
+    // Удаление всех записей группы (поколение группы увеличивается)
+    void invalidate(const std::string& tag);
+
+    // Текущее поколение группы (число инвалидаций)
+    uint64_t generation(const std::string& tag) const;
+
+    // Счетчики попаданий, промахов, вытеснений и объем (для /metrics)
+    Json::Value metrics() const;
+
+private:
+    struct Node {
+        std::string key;
+        std::shared_ptr<const CachedBody> value;
+        Clock::time_point expires;   // Игнорируется для неизменной записи
+        bool immutable;
+        std::string tag;
+        size_t bytes;                // Учитываемый объем записи
+    };
+    using List = std::list<Node>;
+
+    void eraseLocked(List::iterator it);
+
+    const size_t capacity_;                          // Предел объема, байт
+    size_t bytes_ = 0;                               // Текущий объем
+    List lru_;                                       // Начало — недавно использованные
+    std::unordered_map<std::string, List::iterator> index_;
+    std::unordered_map<std::string, uint64_t> generations_; // Поколения групп
+    mutable std::mutex mutex_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> expirations_{0};
+    std::atomic<uint64_t> invalidations_{0};
+};
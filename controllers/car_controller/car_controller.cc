@@ -1,12 +1,17 @@
 #include "car_controller.h"
+#include "../../utilities/json_response.h"
 #include "../../utilities/utilities.h"
 #include "../../sd_bus/sd_bus.h"
+#include "../../utilities/file_watcher.h"
+#include "../../storage/persist_queue.h"
+#include "../../storage/car_record_format.h"
+#include "../../crypto/crypto_engine.h"
+#include "../../struct_data/car_json.h"
 #include <json/json.h>
 #include <fstream>
 #include <filesystem>
 #include <openssl/rand.h>
-#include <openssl/sha.h>
-#include <zlib.h>
+#include <openssl/crypto.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <csignal>
@@ -17,31 +22,242 @@
 using namespace drogon;
 namespace fs = std::filesystem;
 
-// Конструктор контроллера
-CarController::CarController() {
-    // Получение секретов шифрования из переменных окружения
-    secrets_.key = std::getenv("CAR_ENCRYPTION_KEY");
-    secrets_.salt = std::getenv("CAR_ENCRYPTION_SALT");
-    
-    // Проверка наличия обязательных секретов
-    if (secrets_.key.empty() || secrets_.salt.empty()) {
-        LOG_FATAL << "Encryption secrets not configured";
-        throw std::runtime_error("Server misconfiguration");
+namespace {
+// Файл с зашифрованными данными автомобиля
+const std::string kCarFile = "car_detail.bin";
+
+// Верхняя граница размера файла любого формата (старый CBC-формат: 260 байт)
+constexpr size_t kMaxCarFileSize = 512;
+}
+
+// Конструктор контроллера: ключ и учетные данные Wi-Fi готовятся при старте и передаются извне
+CarController::CarController(std::shared_ptr<KeyManager> keys,
+                             std::shared_ptr<WifiCredentials> wifi)
+    : keys_(std::move(keys)), wifi_(std::move(wifi)) {
+    // Первичная загрузка снимка и подписка на внешние изменения файла
+    persister_ = std::make_unique<PersistQueue>(kCarFile);
+    reloadSnapshot();
+    watcher_ = std::make_unique<FileWatcher>(kCarFile, [this] { reloadSnapshot(); });
+}
+
+// Повторное чтение файла и публикация нового снимка
+void CarController::reloadSnapshot() {
+    // Писатели не должны менять файл во время чтения
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    // Событие от собственной фоновой записи: состояние уже известно
+    if(inFlight_ > 0) return;
+
+    std::shared_ptr<const CarSnapshot> snapshot;
+    bool migrate = false;
+    try {
+        snapshot = loadSnapshot(migrate);
+    }
+    catch(const std::exception& e) {
+        // Поврежденный файл: ошибка сохраняется в снимке и отдается читателям,
+        // сам файл не перезаписывается (это единственная копия данных)
+        LOG_ERROR << "Read error: " << e.what();
+        auto failed = std::make_shared<CarSnapshot>();
+        failed->error = e.what();
+        snapshot = failed;
+        migrate = false;
+    }
+    latest_ = snapshot;
+    std::atomic_store(&snapshot_, snapshot);
+
+    // Прозрачная миграция старого формата или устаревших параметров KDF
+    // (только после успешной проверки и расшифровки файла)
+    if(migrate && snapshot && snapshot->error.empty()) {
+        try {
+            std::vector<unsigned char> digest;
+            std::string record = serializeRecord(snapshot->details, digest);
+            LOG_INFO << "Migrating " << kCarFile << " to record format v" << car_record::kVersion;
+            persist(buildSnapshot(snapshot->details, digest.data(), digest.size()), std::move(record), nullptr,
+                    k200OK, "Migration successful");
+        }
+        catch(const std::exception& e) {
+            LOG_ERROR << "Migration error: " << e.what();
+        }
     }
 }
 
+// Чтение и проверка целостности файла (nullptr, если файла нет).
+// migrate выставляется, если файл прочитан и его нужно перезаписать в текущем формате.
+std::shared_ptr<const CarController::CarSnapshot> CarController::loadSnapshot(bool& migrate) {
+    // Файл читается целиком одним вызовом
+    FileDescriptorGuard fd(open(kCarFile.c_str(), O_RDONLY | O_CLOEXEC));
+    if(fd == -1) {
+        if(errno == ENOENT) return nullptr;
+        throw std::runtime_error(strerror(errno));
+    }
+
+    std::vector<unsigned char> data(kMaxCarFileSize);
+    size_t size = 0;
+    while(size < data.size()) {
+        ssize_t got = read(fd, data.data() + size, data.size() - size);
+        if(got == -1) {
+            if(errno == EINTR) continue;
+            throw std::runtime_error(strerror(errno));
+        }
+        if(got == 0) break;
+        size += static_cast<size_t>(got);
+    }
+    if(size == data.size()) {
+        throw std::runtime_error("Invalid file size");
+    }
+
+    // Старый формат без заголовка
+    if(!car_record::hasMagic(data.data(), size)) {
+        auto snapshot = loadLegacySnapshot(data.data(), size);
+        migrate = true;
+        return snapshot;
+    }
+
+    // Проверка тега и расшифровка за один проход
+    auto header = car_record::parseHeader(data.data(), size);
+    CarDetails details;
+    keys_->withKeyFor(static_cast<int>(header.iterations), [&](const unsigned char* key) {
+        car_record::open(data.data(), size, key, details);
+    });
+    migrate = static_cast<int>(header.iterations) != keys_->iterations();
+
+    return buildSnapshot(details, car_record::tag(data.data()), car_record::kTagSize);
+}
+
+// Чтение старого формата: IV + AES-256-CBC + SHA-256 + CRC32
+std::shared_ptr<const CarController::CarSnapshot> CarController::loadLegacySnapshot(
+    const unsigned char* data, size_t size) {
+    // Проверка размера файла
+    const size_t ivSize = crypto_engine::kBlockSize;
+    const size_t minSize = ivSize + crypto_engine::kSha256Size + sizeof(uint32_t);
+    if(size < minSize || size - minSize > sizeof(CarDetails) + crypto_engine::kBlockSize) {
+        throw std::runtime_error("Invalid file size");
+    }
+
+    // Разбор компонентов файла без копирования
+    const unsigned char* iv = data;
+    const size_t encryptedSize = size - minSize;
+    const unsigned char* encryptedData = data + ivSize;
+    const unsigned char* storedSHA = encryptedData + encryptedSize;
+    uint32_t storedCRC;
+    std::memcpy(&storedCRC, data + size - sizeof(storedCRC), sizeof(storedCRC));
+
+    // Расшифровка данных в буфер на стеке
+    unsigned char plain[sizeof(CarDetails) + 2 * crypto_engine::kBlockSize];
+    const size_t plainSize = keys_->withKey([&](const unsigned char* key) {
+        return crypto_engine::cbcDecrypt(key, iv, encryptedData, encryptedSize, plain, sizeof(plain));
+    });
+    if(plainSize != sizeof(CarDetails)) {
+        OPENSSL_cleanse(plain, sizeof(plain));
+        throw std::runtime_error("Invalid decrypted data size");
+    }
+    CarDetails details;
+    std::memcpy(&details, plain, sizeof(details));
+    OPENSSL_cleanse(plain, sizeof(plain));
+
+    // Проверка целостности данных
+    unsigned char hash[crypto_engine::kSha256Size];
+    crypto_engine::sha256(&details, sizeof(details), hash);
+    if(CRYPTO_memcmp(hash, storedSHA, sizeof(hash)) != 0) {
+        throw std::runtime_error("SHA-256 mismatch");
+    }
+
+    if(crypto_engine::crc32(&details, sizeof(details)) != storedCRC) {
+        throw std::runtime_error("CRC32 mismatch");
+    }
+
+    // ETag — HMAC файла под ключом данных: хэш открытого текста (в нем
+    // учетные данные Wi-Fi) наружу не передается
+    unsigned char digest[crypto_engine::kSha256Size];
+    keys_->withKey([&](const unsigned char* key) {
+        crypto_engine::hmacSha256(key, crypto_engine::kKeySize, data, size, digest);
+    });
+    return buildSnapshot(details, digest, sizeof(digest));
+}
+
+// Сборка снимка: ETag и сериализованное тело ответа вычисляются один раз
+std::shared_ptr<const CarController::CarSnapshot> CarController::buildSnapshot(
+    const CarDetails& details, const unsigned char* digest, size_t digestSize) {
+    auto snapshot = std::make_shared<CarSnapshot>();
+    snapshot->details = details;
+    snapshot->etag = makeETag(digest, digestSize);
+
+    Json::Value json;
+    carToJson(details, json);
+    snapshot->body = writeCompactJson(json);
+    return snapshot;
+}
+
+// Сборка записи в текущем формате (AES-256-GCM); digest — тег аутентификации
+std::string CarController::serializeRecord(const CarDetails& details,
+                                           std::vector<unsigned char>& digest) {
+    car_record::Record record;
+    const int iterations = keys_->iterations();
+    keys_->withKeyFor(iterations, [&](const unsigned char* key) {
+        car_record::seal(details, key, static_cast<uint32_t>(iterations), record);
+    });
+
+    const unsigned char* tag = car_record::tag(record.data());
+    digest.assign(tag, tag + car_record::kTagSize);
+    return std::string(reinterpret_cast<const char*>(record.data()), record.size());
+}
+
+// Передача записи в фоновый поток; ответ клиенту отправляется после fsync.
+// Вызывается под writeMutex_.
+void CarController::persist(std::shared_ptr<const CarSnapshot> snapshot, std::string record,
+                            std::function<void(const HttpResponsePtr&)>&& callback,
+                            HttpStatusCode successCode, std::string successMessage) {
+    // Следующие писатели строят изменения поверх принятого состояния
+    latest_ = snapshot;
+    ++inFlight_;
+
+    persister_->submit(
+        std::move(record),
+        // Фиксация: снимок становится видимым читателям только после записи на диск
+        [this, snapshot] { std::atomic_store(&snapshot_, snapshot); },
+        [this, snapshot, callback = std::move(callback), successCode,
+         successMessage = std::move(successMessage)](const std::string& error) mutable {
+            {
+                std::lock_guard<std::mutex> lock(writeMutex_);
+                --inFlight_;
+                // Откат принятого состояния к сохраненному при ошибке записи
+                if(!error.empty() && latest_ == snapshot) {
+                    latest_ = std::atomic_load(&snapshot_);
+                }
+            }
+
+            // Фоновая запись без HTTP-запроса (миграция)
+            if(!callback) {
+                if(!error.empty()) LOG_ERROR << "Persist error: " << error;
+                return;
+            }
+
+            Json::Value response;
+            if(error.empty()) {
+                sendResponse(response["status"] = successMessage, successCode, callback);
+            } else {
+                LOG_ERROR << "Persist error: " << error;
+                sendResponse(response["error"] = error, k500InternalServerError, callback);
+            }
+        });
+}
+
+// Явная ротация ключа
+void CarController::rotateKey(int iterations) {
+    keys_->rotate(iterations);
+    LOG_INFO << "Encryption key rotated";
+}
+
 // Обработчик создания файла с данными автомобиля (POST /car/create)
 void CarController::createCarFile(const HttpRequestPtr& req,
                      std::function<void(const HttpResponsePtr&)>&& callback) {
     Json::Value response;
-    // Блокировка мьютекса для обеспечения потокобезопасности операций с файлом
-    std::lock_guard<std::mutex> lock(fileMutex_);
+    // Блокировка сериализует только писателей; читатели работают со снимком
+    std::lock_guard<std::mutex> lock(writeMutex_);
 
     try {
-        const std::string filename = "car_detail.bin";
-        
-        // Проверка существования файла
-        if (fs::exists(filename)) {
+        // Проверка существования файла (с учетом еще не записанного состояния)
+        if (latest_) {
             throw std::runtime_error("File already exists");
         }
 
@@ -53,33 +269,15 @@ void CarController::createCarFile(const HttpRequestPtr& req,
         CarDetails details;
         parseJsonToStruct(*json, details);
 
-        // Шифрование данных автомобиля
-        auto [encrypted, iv] = encryptData(details);
-        
-        // Вычисление хеша SHA-256 для проверки целостности
-        auto shaHash = computeSHA256(details);
-        
-        // Вычисление контрольной суммы CRC32
-        uint32_t crc = computeCRC32(details);
-
-        // Создание файла с помощью RAII-обертки для дескриптора
-        FileDescriptorGuard fd(open(filename.c_str(), O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR));
-        if(fd == -1) throw std::runtime_error(strerror(errno));
-
-        // Последовательная запись компонентов в файл:
-        // 1. Вектор инициализации (16 байт)
-        writeOrThrow(fd, iv.data(), iv.size(), "IV write failed");
-        // 2. Зашифрованные данные
-        writeOrThrow(fd, encrypted.data(), encrypted.size(), "Data write failed");
-        // 3. Хеш SHA-256 (32 байта)
-        writeOrThrow(fd, shaHash.data(), shaHash.size(), "SHA-256 write failed");
-        // 4. Контрольная сумма CRC32 (4 байта)
-        writeOrThrow(fd, &crc, sizeof(crc), "CRC32 write failed");
-
-        // Логирование успешной операции
+        // Шифрование и сборка записи целиком в памяти
+        std::vector<unsigned char> digest;
+        std::string record = serializeRecord(details, digest);
+
+        // Логирование операции
         LOG_INFO << "File created by " << req->getPeerAddr().toIp();
-        // Отправка успешного ответа
-        sendResponse(response["status"] = "File created successfully", k201Created, callback);
+        // Фоновая запись; ответ отправляется после ее завершения
+        persist(buildSnapshot(details, digest.data(), digest.size()), std::move(record), std::move(callback),
+                k201Created, "File created successfully");
     }
     catch(const std::exception& e) {
         // Обработка ошибок и отправка клиенту 500 ошибки
@@ -92,64 +290,37 @@ void CarController::createCarFile(const HttpRequestPtr& req,
 void CarController::getCarInfo(const HttpRequestPtr& req,
                  std::function<void(const HttpResponsePtr&)>&& callback) {
     Json::Value response;
-    // Блокировка мьютекса для обеспечения потокобезопасности
-    std::lock_guard<std::mutex> lock(fileMutex_);
 
     try {
-        const std::string filename = "car_detail.bin";
-        
-        // Проверка существования файла
-        if(!fs::exists(filename)) {
+        // Снимок читается без блокировок и без обращения к файлу
+        auto snapshot = std::atomic_load(&snapshot_);
+        if(!snapshot) {
             throw std::runtime_error("File not found");
         }
-
-        // Открытие файла в бинарном режиме
-        std::ifstream file(filename, std::ios::binary);
-        auto fileSize = fs::file_size(filename);
-        
-        // Проверка минимального размера файла
-        const size_t minSize = 16 + SHA256_DIGEST_LENGTH + sizeof(uint32_t);
-        if(fileSize < minSize) {
-            throw std::runtime_error("Invalid file size");
-        }
-
-        // Чтение компонентов из файла:
-        std::vector<unsigned char> iv(16); // Вектор инициализации
-        file.read(reinterpret_cast<char*>(iv.data()), iv.size());
-        
-        // Расчет размера зашифрованных данных
-        const size_t encryptedSize = fileSize - iv.size() - SHA256_DIGEST_LENGTH - sizeof(uint32_t);
-        std::vector<unsigned char> encryptedData(encryptedSize);
-        file.read(reinterpret_cast<char*>(encryptedData.data()), encryptedSize);
-        
-        // Чтение сохраненного SHA-256 хеша
-        std::vector<unsigned char> storedSHA(SHA256_DIGEST_LENGTH);
-        file.read(reinterpret_cast<char*>(storedSHA.data()), storedSHA.size());
-        
-        // Чтение сохраненной контрольной суммы
-        uint32_t storedCRC;
-        file.read(reinterpret_cast<char*>(&storedCRC), sizeof(storedCRC));
-
-        // Расшифровка данных
-        CarDetails details = decryptData(encryptedData, iv);
-
-        // Вычисление текущих значений хеша и CRC
-        auto computedSHA = computeSHA256(details);
-        uint32_t computedCRC = computeCRC32(details);
-
-        // Проверка целостности данных
-        if(computedSHA != storedSHA) {
-            throw std::runtime_error("SHA-256 mismatch");
+        if(!snapshot->error.empty()) {
+            throw std::runtime_error(snapshot->error);
         }
 
-        if(computedCRC != storedCRC) {
-            throw std::runtime_error("CRC32 mismatch");
+        // Формат по Accept (JSON по умолчанию); у каждого формата свой ETag
+        const auto format = negotiateBinaryFormat(req->getHeader("Accept"));
+        const std::string etag = representationETag(snapshot->etag, format);
+
+        // Условный запрос: версия клиента совпадает с текущей
+        const auto& ifNoneMatch = req->getHeader("If-None-Match");
+        if(!ifNoneMatch.empty() && etagMatches(ifNoneMatch, etag)) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k304NotModified);
+            resp->addHeader("ETag", etag);
+            resp->addHeader("Cache-Control", "no-cache");
+            callback(resp);
+            return;
         }
 
-        // Конвертация структуры в JSON
-        Json::Value jsonResponse;
-        convertToJson(details, jsonResponse);
-        sendResponse(jsonResponse, k200OK, callback);
+        // Отдача заранее сериализованного тела текущей версии
+        auto resp = newNegotiatedResponse(std::string(snapshot->body), format);
+        resp->addHeader("ETag", etag);
+        resp->addHeader("Cache-Control", "no-cache");
+        callback(resp);
     }
     catch(const std::exception& e) {
         // Обработка ошибок чтения
@@ -158,36 +329,6 @@ void CarController::getCarInfo(const HttpRequestPtr& req,
     }
 }
 
-// Запись данных в файл с гарантией полной записи
-void CarController::writeOrThrow(int fd, const void* data, size_t size, const char* errorMsg) {
-    ssize_t written = write(fd, data, size);
-    if(written != static_cast<ssize_t>(size)) {
-        throw std::runtime_error(std::string(errorMsg) + ": " + strerror(errno));
-    }
-}
-
-// Вычисление SHA-256 хеша структуры
-std::vector<unsigned char> CarController::computeSHA256(const CarDetails& data) {
-    std::vector<unsigned char> hash(SHA256_DIGEST_LENGTH);
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    
-    // Инициализация контекста хеширования
-    EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
-    // Обновление хеша данными структуры
-    EVP_DigestUpdate(ctx, &data, sizeof(data));
-    // Финализация хеша
-    EVP_DigestFinal_ex(ctx, hash.data(), nullptr);
-    
-    // Очистка ресурсов OpenSSL
-    EVP_MD_CTX_free(ctx);
-    return hash;
-}
-
-// Вычисление контрольной CRC32
-uint32_t CarController::computeCRC32(const CarDetails& data) {
-    return crc32(0, reinterpret_cast<const Bytef*>(&data), sizeof(data));
-}
-
 // Формирование HTTP-ответа
 void CarController::sendResponse(Json::Value& response, HttpStatusCode code,
                     std::function<void(const HttpResponsePtr&)>& callback) {
@@ -209,308 +350,47 @@ void CarController::parseJsonToStruct(const Json::Value& json, CarDetails& detai
     // Получение учетных данных Wi-Fi
     auto [ssid, password] = getSsidAndPassword();
 
-    // Лямбда для безопасного копирования строк
-    auto safeCopy = [](const std::string& src, char* dest, size_t max) {
-        if(src.length() >= max) throw std::runtime_error("Field length exceeded");
-        snprintf(dest, max, "%s", src.c_str());
-    };      
-
     // Копирование SSID и пароля
-    safeCopy(ssid, details.wi_fi, sizeof(details.wi_fi));
-    safeCopy(password, details.password, sizeof(details.password));
-
-    // Лямбда для обработки полей JSON
-    auto copyField = [&](const char* field, char* dest, size_t max) {
-        if(!json.isMember(field)) throw std::runtime_error("Missing field: " + std::string(field));
-        safeCopy(json[field].asString(), dest, max);
-    };
-
-    // Обработка каждого поля с валидацией
-    copyField("vin", details.vin, 18);
-    validateVIN(details.vin); // Валидация VIN
-    
-    copyField("license_plate", details.license_plate, 10);
-    copyField("brand", details.brand, 20);
-    copyField("model", details.model, 20);
-    copyField("body_type", details.body_type, 20);
-    copyField("body_number", details.body_number, 10);
-    copyField("engine_type", details.engine_type, 4);
-    copyField("color", details.color, 20);
-    
-    // Обработка числовых полей
-    details.year = json.get("year", 0).asInt();
-    if(details.year < 1886 || details.year > 2024) {
-        throw std::runtime_error("Invalid production year");
-    }
-    
-    // Обработка поля трансмиссии
-    std::string transmission = json.get("transmission", "").asString();
-    details.transmission = !transmission.empty() ? transmission[0] : ' ';
-    
-    // Проверка объема двигателя
-    details.engine_volume = json.get("engine_volume", 0.0f).asFloat();
-    if(details.engine_volume < 0) {
-        throw std::runtime_error("Invalid engine volume");
-    }
-    
-    // Проверка мощности двигателя
-    details.engine_power = json.get("engine_power", 0).asInt();
-    if(details.engine_power < 0) {
-        throw std::runtime_error("Invalid engine power");
-    }
-}
-
-// Валидация VIN номера
-void CarController::validateVIN(const char* vin) {
-    static const std::regex vinRegex(R"(^[A-HJ-NPR-Z\d]{17}$)");
-    if(!std::regex_match(vin, vinRegex)) {
-        throw std::runtime_error("Invalid VIN format");
-    }
-}
-
-// Конвертация структуры в JSON
-void CarController::convertToJson(const CarDetails& details, Json::Value& json) {
-    json["wi_fi"] = details.wi_fi;
-    json["password"] = "[hidden]";  // Маскировка пароля
-    json["vin"] = details.vin;
-    json["license_plate"] = details.license_plate;
-    json["brand"] = details.brand;
-    json["model"] = details.model;
-    json["year"] = details.year;
-    json["transmission"] = std::string(1, details.transmission);
-    json["body_type"] = details.body_type;
-    json["body_number"] = details.body_number;
-    json["engine_volume"] = details.engine_volume;
-    json["engine_power"] = details.engine_power;
-    json["engine_type"] = details.engine_type;
-    json["color"] = details.color;
-}
+    copyCarField(ssid, details.wi_fi, sizeof(details.wi_fi));
+    copyCarField(password, details.password, sizeof(details.password));
 
-// Шифрование данных автомобиля
-std::pair<std::vector<unsigned char>, std::vector<unsigned char>> CarController::encryptData(const CarDetails& data) {
-    unsigned char key[32];
-    std::vector<unsigned char> iv(16); // Вектор инициализации
-    
-    // Генерация ключа и вектора инициализации
-    deriveKey(key);
-    if(RAND_bytes(iv.data(), 16) != 1) {
-        throw std::runtime_error("IV generation failed");
-    }
-
-    // Создание контекста шифрования
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    auto ctxGuard = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>(
-        ctx, EVP_CIPHER_CTX_free);
-    
-    // Инициализация AES-256-CBC
-    if(EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key, iv.data()) != 1) {
-        throw std::runtime_error("Encryption init failed");
-    }
-
-    // Шифрование данных
-    const int blockSize = EVP_CIPHER_CTX_block_size(ctx);
-    std::vector<unsigned char> ciphertext(sizeof(data) + blockSize);
-    int len = 0, totalLen = 0;
-
-    // Шифрование основного блока данных
-    if(EVP_EncryptUpdate(ctx, ciphertext.data(), &len, 
-                       reinterpret_cast<const unsigned char*>(&data), sizeof(data)) != 1) {
-        throw std::runtime_error("Encryption failed");
-    }
-    totalLen = len;
-
-    // Финализация шифрования
-    if(EVP_EncryptFinal_ex(ctx, ciphertext.data() + totalLen, &len) != 1) {
-        throw std::runtime_error("Encryption finalization failed");
-    }
-    totalLen += len;
-
-    ciphertext.resize(totalLen);
-    return {ciphertext, iv};
+    // Остальные поля с валидацией
+    parseCarJson(json, details);
 }
 
-// Дешифровка данных
-CarDetails CarController::decryptData(const std::vector<unsigned char>& ciphertext, const std::vector<unsigned char>& iv) {
-    unsigned char key[32];
-    deriveKey(key); // Генерация ключа
-
-    // Создание контекста дешифрования
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    auto ctxGuard = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>(
-        ctx, EVP_CIPHER_CTX_free);
-    
-    // Инициализация AES-256-CBC
-    if(EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key, iv.data()) != 1) {
-        throw std::runtime_error("Decryption init failed");
-    }
-
-    CarDetails plaintext;
-    int len = 0, totalLen = 0;
-
-    // Дешифровка основного блока
-    if(EVP_DecryptUpdate(ctx, reinterpret_cast<unsigned char*>(&plaintext), &len,
-                       ciphertext.data(), ciphertext.size()) != 1) {
-        throw std::runtime_error("Decryption failed");
-    }
-    totalLen = len;
-
-    // Финализация дешифрования
-    if(EVP_DecryptFinal_ex(ctx, reinterpret_cast<unsigned char*>(&plaintext) + totalLen, &len) != 1) {
-        throw std::runtime_error("Decryption finalization failed");
-    }
-    totalLen += len;
-
-    // Проверка размера расшифрованных данных
-    if(totalLen != sizeof(CarDetails)) {
-        throw std::runtime_error("Invalid decrypted data size");
-    }
-
-    return plaintext;
-}
-
-// Генерация ключа с использованием PBKDF2
-void CarController::deriveKey(unsigned char* key) {
-    auto& config = app().getCustomConfig();
-    int iterations = config.get("security", "pbkdf2_iterations", 100000).asInt();
-
-    // Использование PBKDF2 для генерации ключа
-    if(PKCS5_PBKDF2_HMAC(
-        secrets_.key.c_str(), secrets_.key.length(),
-        reinterpret_cast<const unsigned char*>(secrets_.salt.c_str()), secrets_.salt.length(),
-        iterations, EVP_sha256(), 32, key) != 1) {
-        throw std::runtime_error("Key derivation failed");
-    }
-}
-
-// Получение учетных данных Wi-Fi
+// Получение учетных данных Wi-Fi (расшифрованы в фоне при старте)
 std::pair<std::string, std::string> CarController::getSsidAndPassword() {
-    static std::pair<std::string, std::string> credentials;
-    static std::once_flag flag; // Гарантия однократного выполнения
-    
-    std::call_once(flag, [this] {
-        try {
-            // Расшифровка SSID
-            credentials.first = executeCommand(
-                "openssl enc -d -aes-256-cbc -a -salt -pbkdf2 -iter 10000 -pass file:/etc/wifi_ap/encryption_key -in /etc/wifi_ap/encrypted_ssid"
-            );
-            // Расшифровка пароля
-            credentials.second = executeCommand(
-                "openssl enc -d -aes-256-cbc -a -salt -pbkdf2 -iter 10000 -pass file:/etc/wifi_ap/encryption_key -in /etc/wifi_ap/encrypted_password"
-            );
-            
-            // Проверка полученных данных
-            if(credentials.first.empty() || credentials.second.empty()) {
-                throw std::runtime_error("Invalid WiFi credentials");
-            }
-        } catch (const std::exception& e) {
-            LOG_FATAL << "WiFi error: " << e.what();
-            throw;
-        }
-    });
-    
-    return credentials;
+    return wifi_->get();
 }
 
 void CarController::updateCarFile(const HttpRequestPtr& req,
                    std::function<void(const HttpResponsePtr&)>&& callback) {
     Json::Value response;
-    std::lock_guard<std::mutex> lock(fileMutex_);
+    std::lock_guard<std::mutex> lock(writeMutex_);
     
     try {
-        const std::string filename = "car_detail.bin";
-        if(!fs::exists(filename)) {
+        // 1. Текущие данные берутся из последнего принятого состояния
+        auto snapshot = latest_;
+        if(!snapshot) {
             throw std::runtime_error("File not found");
         }
-
-        // 1. Чтение текущих данных
-        std::ifstream file(filename, std::ios::binary);
-        std::vector<unsigned char> iv(16);
-        file.read(reinterpret_cast<char*>(iv.data()), iv.size());
-        
-        auto fileSize = fs::file_size(filename);
-        const size_t encryptedSize = fileSize - iv.size() - SHA256_DIGEST_LENGTH - sizeof(uint32_t);
-        std::vector<unsigned char> encryptedData(encryptedSize);
-        file.read(reinterpret_cast<char*>(encryptedData.data()), encryptedSize);
-        
-        CarDetails currentData = decryptData(encryptedData, iv);
+        if(!snapshot->error.empty()) {
+            throw std::runtime_error(snapshot->error);
+        }
+        CarDetails currentData = snapshot->details;
 
         // 2. Парсинг входящего JSON
         auto json = req->getJsonObject();
         if(!json) throw std::runtime_error("Invalid JSON");
 
         // 3. Обновление разрешенных полей
-        for (const auto& key : json->getMemberNames()) {
-            const std::string field = key;
-            const Json::Value& value = (*json)[key];
-            
-            if(field == "license_plate") {
-                std::string plateValue = value.asString();
-                if(plateValue.length() > 9) throw std::runtime_error("License plate too long");
-                std::fill(std::begin(currentData.license_plate), 
-                        std::end(currentData.license_plate), 0);
-                std::copy(plateValue.begin(), plateValue.end(), currentData.license_plate);
-            }
-            else if(field == "transmission") {
-                std::string transmissionValue = value.asString();
-                if(transmissionValue.empty()) continue;
-                currentData.transmission = transmissionValue[0];
-            }
-            else if(field == "body_type") {
-                std::string bodyTypeValue = value.asString();
-                if(bodyTypeValue.length() > 19) throw std::runtime_error("Body type too long");
-                std::fill(std::begin(currentData.body_type), 
-                        std::end(currentData.body_type), 0);
-                std::copy(bodyTypeValue.begin(), bodyTypeValue.end(), currentData.body_type);
-            }
-            else if(field == "engine_volume") {
-                float engineVolumeValue = value.asFloat();
-                if(engineVolumeValue <= 0) throw std::runtime_error("Invalid engine volume");
-                currentData.engine_volume = engineVolumeValue;
-            }
-            else if(field == "engine_power") {
-                int enginePowerValue = value.asInt();
-                if(enginePowerValue < 0) throw std::runtime_error("Invalid engine power");
-                currentData.engine_power = enginePowerValue;
-            }
-            else if(field == "engine_type") {
-                std::string engineTypeValue = value.asString();
-                if(engineTypeValue.length() > 3) throw std::runtime_error("Engine type too long");
-                std::fill(std::begin(currentData.engine_type), 
-                        std::end(currentData.engine_type), 0);
-                std::copy(engineTypeValue.begin(), engineTypeValue.end(), currentData.engine_type);
-            }
-            else if(field == "color") {
-                std::string colorValue = value.asString();
-                if(colorValue.length() > 19) throw std::runtime_error("Color name too long");
-                std::fill(std::begin(currentData.color), 
-                        std::end(currentData.color), 0);
-                std::copy(colorValue.begin(), colorValue.end(), currentData.color);
-            }
-            else {
-                LOG_WARN << "Attempt to modify restricted field: " << field;
-                throw std::runtime_error("Modifying field " + field + " is prohibited");
-            }
-        }
-
-        // 4. Перезапись файла
-        auto newEncryptedData = encryptData(currentData);
-        auto newSHA = computeSHA256(currentData);
-        auto newCRC = computeCRC32(currentData);
-
-        // Открываем файл для записи
-        FileDescriptorGuard fd(open(filename.c_str(), O_WRONLY | O_TRUNC));
-
-        // Записываем НОВЫЙ IV из newEncryptedData.second
-        writeOrThrow(fd, newEncryptedData.second.data(), newEncryptedData.second.size(), "IV write failed");
-
-        // Записываем зашифрованные данные
-        writeOrThrow(fd, newEncryptedData.first.data(), newEncryptedData.first.size(), "Data write failed");
-
-        // Записываем новые хеши и CRC
-        writeOrThrow(fd, newSHA.data(), newSHA.size(), "SHA write failed");
-        writeOrThrow(fd, &newCRC, sizeof(newCRC), "CRC write failed");
+        applyCarPatch(*json, currentData);
 
-        sendResponse(response["status"] = "Update successful", k200OK, callback);
+        // 4. Фоновая атомарная перезапись файла
+        std::vector<unsigned char> digest;
+        std::string record = serializeRecord(currentData, digest);
+        persist(buildSnapshot(currentData, digest.data(), digest.size()), std::move(record), std::move(callback),
+                k200OK, "Update successful");
     }
     catch(const std::exception& e) {
         LOG_ERROR << "Update failed: " << e.what();
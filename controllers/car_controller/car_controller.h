@@ -4,6 +4,11 @@
 #include <drogon/HttpController.h>  // Базовый класс для HTTP контроллеров
 #include <drogon/drogon.h>          // Основная библиотека Drogon
 #include "../../struct_data/car_struct.h"             // Структура CarDetails
+#include "../../crypto/key_manager.h"                 // Резидентный ключ шифрования
+#include "../../crypto/wifi_credentials.h"            // Учетные данные точки доступа
+#include "../../utilities/file_watcher.h"             // Отслеживание изменений файла
+#include "../../storage/persist_queue.h"              // Фоновая атомарная запись файла
+#include <memory>                   // Умные указатели
 #include <mutex>                    // Мьютекс для синхронизации
 #include <openssl/evp.h>            // OpenSSL функции шифрования
 #include <vector>                   // Контейнер vector
@@ -13,7 +18,10 @@
 // Контроллер для работы с данными автомобиля
 class CarController : public drogon::HttpController<CarController> {
 public:
-    CarController();  // Конструктор
+    CarController(std::shared_ptr<KeyManager> keys,
+                  std::shared_ptr<WifiCredentials> wifi);  // Конструктор
+
+    static const bool isAutoCreation = false;
     
     METHOD_LIST_BEGIN
         // Регистрация методов API:
@@ -29,28 +37,43 @@ public:
     void getCarInfo(const drogon::HttpRequestPtr& req,
                  std::function<void(const drogon::HttpResponsePtr&)>&& callback);
 
+    // Явная ротация ключа (повторный вывод PBKDF2 с новым числом итераций)
+    void rotateKey(int iterations);
+
 private:
-    // Структура для хранения секретов шифрования
-    struct EncryptionSecrets {
-        std::string key;   // Ключ шифрования
-        std::string salt;   // Соль для генерации ключа
+    // Неизменяемый проверенный снимок данных автомобиля.
+    // Публикуется атомарной заменой указателя; читатели не блокируются.
+    struct CarSnapshot {
+        CarDetails details;  // Расшифрованные данные
+        std::string etag;    // Строгий ETag (тег GCM записи; для старого формата — HMAC файла)
+        std::string body;    // Сериализованный JSON для GET /car/info
+        std::string error;   // Ошибка чтения файла (если файл поврежден)
     };
 
-    std::mutex fileMutex_;          // Мьютекс для защиты доступа к файлу
-    EncryptionSecrets secrets_;     // Секреты шифрования
+    std::mutex writeMutex_;         // Сериализация писателей (создание/обновление/перечитывание)
+    std::shared_ptr<KeyManager> keys_; // Ключ шифрования, выведенный при старте
+    std::shared_ptr<WifiCredentials> wifi_; // Учетные данные Wi-Fi, расшифрованные при старте
+    std::shared_ptr<const CarSnapshot> snapshot_; // Сохраненный снимок (nullptr — файла нет)
+    std::shared_ptr<const CarSnapshot> latest_;   // Последнее принятое состояние (под writeMutex_)
+    size_t inFlight_ = 0;                         // Записи, ожидающие завершения (под writeMutex_)
+    std::unique_ptr<PersistQueue> persister_;     // Фоновая запись файла
+    std::unique_ptr<FileWatcher> watcher_;        // Наблюдатель за внешними изменениями файла
+
+    // Работа со снимком:
+    void reloadSnapshot();
+    std::shared_ptr<const CarSnapshot> loadSnapshot(bool& migrate);
+    std::shared_ptr<const CarSnapshot> loadLegacySnapshot(const unsigned char* data, size_t size);
+    std::shared_ptr<const CarSnapshot> buildSnapshot(const CarDetails& details,
+                                                     const unsigned char* digest, size_t digestSize);
+    std::string serializeRecord(const CarDetails& details, std::vector<unsigned char>& digest);
+    void persist(std::shared_ptr<const CarSnapshot> snapshot, std::string record,
+                 std::function<void(const drogon::HttpResponsePtr&)>&& callback,
+                 drogon::HttpStatusCode successCode, std::string successMessage);
 
     // Вспомогательные методы:
-    void writeOrThrow(int fd, const void* data, size_t size, const char* errorMsg);
-    std::vector<unsigned char> computeSHA256(const CarDetails& data);
-    uint32_t computeCRC32(const CarDetails& data);
     void sendResponse(Json::Value& response, drogon::HttpStatusCode code,
                     std::function<void(const drogon::HttpResponsePtr&)>& callback);
     void parseJsonToStruct(const Json::Value& json, CarDetails& details);
-    void validateVIN(const char* vin);
-    void convertToJson(const CarDetails& details, Json::Value& json);
-    std::pair<std::vector<unsigned char>, std::vector<unsigned char>> encryptData(const CarDetails& data);
-    CarDetails decryptData(const std::vector<unsigned char>& ciphertext, const std::vector<unsigned char>& iv);
-    void deriveKey(unsigned char* key);
     std::pair<std::string, std::string> getSsidAndPassword();
     void updateCarFile(const drogon::HttpRequestPtr& req,
         std::function<void(const drogon::HttpResponsePtr&)>&& callback);
@@ -1,7 +1,7 @@
 #include "daily_report_controller.h"
+#include "../../utilities/utilities.h"
 #include <drogon/drogon.h>
 #include <json/json.h>
-#include <ctime>
 
 using namespace drogon;
 using namespace drogon::orm;
@@ -11,45 +11,21 @@ void DailyReportController::getDailyReport(
     std::function<void(const HttpResponsePtr&)>&& callback,
     const std::string& date_str
 ) {
-    Json::StreamWriterBuilder writer;
-    writer.settings_["emitUTF8"] = true;
-    writer.settings_["indentation"] = "";
-
     try {
-        // Валидация формата даты
-        std::tm tm = {};
-        if (!strptime(date_str.c_str(), "%Y-%m-%d", &tm)) {
+        // Валидация и нормализация даты
+        std::string date;
+        if (!normalizeDate(date_str, date)) {
             throw std::invalid_argument("Неверный формат даты. Используйте YYYY-MM-DD");
         }
 
-        dbClient_->execSqlAsync(
-            "SELECT get_daily_report($1::DATE) as report;",
-            [callback, writer](const Result& result) mutable {
-                if (!result.empty()) {
-                    auto reportJson = result[0]["report"].as<Json::Value>();
-                    auto resp = HttpResponse::newHttpResponse();
-                    resp->setBody(Json::writeString(writer, reportJson));
-                    resp->setContentTypeCodeAndCustomString(
-                        CT_APPLICATION_JSON,
-                        "application/json; charset=utf-8"
-                    );
-                    callback(resp);
-                } else {
-                    Json::Value error;
-                    error["error"] = "Данные за указанную дату отсутствуют";
-                    callback(HttpResponse::newHttpJsonResponse(error));
-                }
-            },
-            [callback](const DrogonDbException& e) {
-                LOG_ERROR << "Ошибка ежедневного отчета: " << e.base().what();
-                Json::Value errorResp;
-                errorResp["error"] = "Ошибка генерации отчета";
-                auto resp = HttpResponse::newHttpJsonResponse(errorResp);
-                resp->setStatusCode(k500InternalServerError);
-                callback(resp);
-            },
-            date_str
-        );
+        // Отчет за прошедший день не меняется и кэшируется без TTL
+        ReportQuery query{
+            StatementId::DailyReport, "report",
+            "daily|" + date, isPastDate(date), "",
+            "Данные за указанную дату отсутствуют",
+            "Ошибка ежедневного отчета"
+        };
+        reports_->fetch(query, req, std::move(callback), date);
     } catch (const std::exception& e) {
         Json::Value error;
         error["error"] = e.what();
@@ -57,4 +33,4 @@ void DailyReportController::getDailyReport(
         resp->setStatusCode(k400BadRequest);
         callback(resp);
     }
-}
\ No newline at end of file
+}
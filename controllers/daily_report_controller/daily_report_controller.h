@@ -1,13 +1,14 @@
 #pragma once
 #include <drogon/HttpController.h>
 #include <drogon/orm/DbClient.h>
+#include "../../cache/report_fetcher.h"
 
 using namespace drogon;
 using namespace drogon::orm;
 
 class DailyReportController : public HttpController<DailyReportController> {
 public:
-    explicit DailyReportController(const DbClientPtr& dbClient) : dbClient_(dbClient) {}
+    explicit DailyReportController(std::shared_ptr<ReportFetcher> reports) : reports_(std::move(reports)) {}
 
     static const bool isAutoCreation = false;
 
@@ -23,5 +24,5 @@ public:
     );
 
 private:
-    DbClientPtr dbClient_;
+    std::shared_ptr<ReportFetcher> reports_; // Выдача отчетов через кэш
 };
\ No newline at end of file
@@ -1,22 +1,73 @@
 #include "date_controller.h"
+#include "../../utilities/json_response.h"
 #include "../../utilities/utilities.h"
+#include "../../utilities/pagination.h"
 #include <drogon/drogon.h>
 #include <json/json.h>
 
 using namespace drogon;
 using namespace drogon::orm;
 
+namespace {
+// Ответ с ошибкой параметров запроса
+void sendBadRequest(const std::exception& e, std::function<void(const HttpResponsePtr&)>& callback) {
+    Json::Value error;
+    error["error"] = e.what();
+    auto resp = HttpResponse::newHttpJsonResponse(error);
+    resp->setStatusCode(k400BadRequest);
+    callback(resp);
+}
+}
+
+// Страница дат (при limit/cursor в запросе)
+void DateController::getDatesPage(
+    StatementId statement,
+    const PageRequest& page,
+    std::optional<BinaryFormat> format,
+    std::function<void(const HttpResponsePtr&)>&& callback
+) {
+    db_->execAsync(
+        statement,
+        [callback, format](const Result& result) {
+            callback(newPageResponse("items", result[0], format));
+        },
+        [callback, statement](const DrogonDbException& e) {
+            LOG_ERROR << "Dates page error (" << StatementRegistry::name(statement)
+                      << "): " << e.base().what();
+            Json::Value errorResp;
+            errorResp["error"] = "Failed to get dates";
+            auto resp = HttpResponse::newHttpJsonResponse(errorResp);
+            resp->setStatusCode(k500InternalServerError);
+            callback(resp);
+        },
+        page.after,
+        page.limit
+    );
+}
+
 void DateController::getUniqueDates(
     const HttpRequestPtr& req,
     std::function<void(const HttpResponsePtr&)>&& callback
 ) {
+    PageRequest page;
+    try {
+        page = parsePageRequest(req);
+    } catch (const std::exception& e) {
+        sendBadRequest(e, callback);
+        return;
+    }
+    if (page.enabled) {
+        getDatesPage(StatementId::UniqueDatesPage, page,
+                     negotiateBinaryFormat(req->getHeader("Accept")), std::move(callback));
+        return;
+    }
+
     Json::Value response;
-    dbClient_->execSqlAsync(
-        "SELECT get_unique_dates() as dates;",
+    db_->execAsync(
+        StatementId::UniqueDates,
         [callback, response](const Result& result) mutable {
             if (!result.empty()) {
-                auto datesJson = result[0]["dates"].as<Json::Value>();
-                callback(HttpResponse::newHttpJsonResponse(datesJson));
+                callback(newRawJsonResponse(result[0]["dates"]));
             } else {
                 response["error"] = "No dates found";
                 callback(HttpResponse::newHttpJsonResponse(response));
@@ -34,13 +85,25 @@ void DateController::getMaintenanceDates(
     const HttpRequestPtr& req,
     std::function<void(const HttpResponsePtr&)>&& callback
 ) {
+    PageRequest page;
+    try {
+        page = parsePageRequest(req);
+    } catch (const std::exception& e) {
+        sendBadRequest(e, callback);
+        return;
+    }
+    if (page.enabled) {
+        getDatesPage(StatementId::MaintenanceDatesPage, page,
+                     negotiateBinaryFormat(req->getHeader("Accept")), std::move(callback));
+        return;
+    }
+
     Json::Value response;
-    dbClient_->execSqlAsync(
-        "SELECT get_maintenance_dates() as maintenance_dates;",
+    db_->execAsync(
+        StatementId::MaintenanceDates,
         [callback, response](const Result& result) mutable {
             if (!result.empty()) {
-                auto datesJson = result[0]["maintenance_dates"].as<Json::Value>();
-                callback(HttpResponse::newHttpJsonResponse(datesJson));
+                callback(newRawJsonResponse(result[0]["maintenance_dates"]));
             } else {
                 response["error"] = "No maintenance dates found";
                 callback(HttpResponse::newHttpJsonResponse(response));
@@ -1,13 +1,15 @@
 #pragma once
 #include <drogon/HttpController.h>
 #include <drogon/orm/DbClient.h>
+#include "../../db/statement_registry.h"
+#include "../../utilities/pagination.h"
 
 using namespace drogon;
 using namespace drogon::orm;
 
 class DateController : public HttpController<DateController> {
 public:
-    explicit DateController(const DbClientPtr& dbClient) : dbClient_(dbClient) {}
+    explicit DateController(std::shared_ptr<StatementRegistry> db) : db_(std::move(db)) {}
 
     static const bool isAutoCreation = false;
 
@@ -27,5 +29,12 @@ public:
     );
 
 private:
-    DbClientPtr dbClient_;
+    void getDatesPage(
+        StatementId statement,
+        const PageRequest& page,
+        std::optional<BinaryFormat> format,
+        std::function<void(const HttpResponsePtr&)>&& callback
+    );
+
+    std::shared_ptr<StatementRegistry> db_; // Реестр запросов к БД
 };
\ No newline at end of file
@@ -0,0 +1,457 @@
+#include "fleet_controller.h"
+#include "../../utilities/json_response.h"
+#include "../../storage/car_record_format.h"
+#include "../../struct_data/car_json.h"
+#include "../../utilities/utilities.h"
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <cctype>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+
+constexpr size_t kMaxBatchItems = 50000; // Предел элементов в одном пакете
+
+// Ответ с ошибкой в формате JSON
+void sendError(std::function<void(const HttpResponsePtr&)>& callback,
+               HttpStatusCode code, const std::string& message) {
+    Json::Value error;
+    error["error"] = message;
+    auto resp = HttpResponse::newHttpJsonResponse(error);
+    resp->setStatusCode(code);
+    callback(resp);
+}
+
+// Отказ при заполненной очереди пула
+void sendBusy(std::function<void(const HttpResponsePtr&)>& callback) {
+    Json::Value error;
+    error["error"] = "Server is busy, retry later";
+    auto resp = HttpResponse::newHttpJsonResponse(error);
+    resp->setStatusCode(k503ServiceUnavailable);
+    resp->addHeader("Retry-After", "1");
+    callback(resp);
+}
+
+// Разбор одной строки NDJSON (читатель свой у каждого потока пула)
+void parseLine(std::string_view line, Json::Value& out) {
+    thread_local std::unique_ptr<Json::CharReader> reader(
+        Json::CharReaderBuilder().newCharReader());
+    std::string errors;
+    if (!reader->parse(line.data(), line.data() + line.size(), &out, &errors)) {
+        throw std::invalid_argument("Invalid JSON: " + errors);
+    }
+}
+
+// Ответ пакетной операции в формате запроса
+void sendBatch(std::function<void(const HttpResponsePtr&)>& callback,
+               std::string&& body, bool ndjson) {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setBody(std::move(body));
+    if (ndjson) {
+        resp->setContentTypeCodeAndCustomString(CT_CUSTOM, "application/x-ndjson");
+    } else {
+        resp->setContentTypeCodeAndCustomString(
+            CT_APPLICATION_JSON,
+            "application/json; charset=utf-8"
+        );
+    }
+    callback(resp);
+}
+}
+
+// Состояние пакетной операции, общее для задач пула.
+// Каждая задача пишет только в свои индексы векторов.
+struct FleetController::BatchJob {
+    HttpRequestPtr req;                           // Владелец тела (строки NDJSON ссылаются на него)
+    bool ndjson = false;                          // Формат запроса и ответа
+    std::shared_ptr<Json::Value> array;           // Элементы JSON-массива
+    std::vector<std::string_view> lines;          // Строки NDJSON
+    std::vector<std::string> vins;                // VIN элемента
+    std::vector<std::string> values;              // Запись или сериализованный результат
+    std::vector<std::string> errors;              // Ошибка элемента (пусто — успех)
+    std::function<void(const HttpResponsePtr&)> callback;
+
+    size_t size() const { return ndjson ? lines.size() : array->size(); }
+
+    // Элемент пакета как JSON
+    void item(size_t i, Json::Value& out) const {
+        if (ndjson) {
+            parseLine(lines[i], out);
+        } else {
+            out = (*array)[static_cast<Json::ArrayIndex>(i)];
+        }
+    }
+};
+
+// Создание записи автомобиля (POST /cars).
+// Шифрование и запись в журнал (fdatasync, возможное уплотнение)
+// выполняются в пуле, ответ отправляется по завершении записи.
+void FleetController::createCar(
+    const HttpRequestPtr& req,
+    std::function<void(const HttpResponsePtr&)>&& callback
+) {
+    auto details = std::make_shared<CarDetails>();
+    try {
+        auto json = req->getJsonObject();
+        if (!json) throw std::invalid_argument("Invalid JSON format");
+        parseCarJson(*json, *details);
+    } catch (const std::exception& e) {
+        sendError(callback, k400BadRequest, e.what());
+        return;
+    }
+
+    auto shared = std::make_shared<std::function<void(const HttpResponsePtr&)>>(std::move(callback));
+    const bool queued = pool_->trySubmit([this, details, shared] {
+        auto& callback = *shared;
+        try {
+            if (!store_->insert(details->vin, sealRecord(*details))) {
+                sendError(callback, k409Conflict, "Car already exists");
+                return;
+            }
+
+            Json::Value response;
+            response["status"] = "Car created successfully";
+            response["vin"] = details->vin;
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k201Created);
+            callback(resp);
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Fleet create error: " << e.what();
+            sendError(callback, k500InternalServerError, e.what());
+        }
+    });
+    if (!queued) sendBusy(*shared);
+}
+
+// Получение записи автомобиля по VIN (GET /car/{vin}/info)
+void FleetController::getCarInfo(
+    const HttpRequestPtr& req,
+    std::function<void(const HttpResponsePtr&)>&& callback,
+    const std::string& vin
+) {
+    try {
+        std::string record;
+        if (!store_->get(vin, record)) {
+            sendError(callback, k404NotFound, "Car not found");
+            return;
+        }
+
+        // ETag из тега записи: условный запрос обходится без расшифровки
+        const auto* data = reinterpret_cast<const unsigned char*>(record.data());
+        const auto header = car_record::parseHeader(data, record.size()); // Проверка размера и версии
+        const auto format = negotiateBinaryFormat(req->getHeader("Accept"));
+        const std::string etag = representationETag(
+            makeETag(car_record::tag(data), car_record::kTagSize), format);
+        const auto& ifNoneMatch = req->getHeader("If-None-Match");
+        if (!ifNoneMatch.empty() && etagMatches(ifNoneMatch, etag)) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k304NotModified);
+            resp->addHeader("ETag", etag);
+            callback(resp);
+            return;
+        }
+
+        auto respond = [this, record = std::move(record), format, etag](
+                           std::function<void(const HttpResponsePtr&)>& callback) {
+            try {
+                CarDetails details;
+                openRecord(record, details);
+
+                Json::Value json;
+                carToJson(details, json);
+                auto resp = newNegotiatedResponse(writeCompactJson(json), format);
+                resp->addHeader("ETag", etag);
+                callback(resp);
+            } catch (const std::exception& e) {
+                LOG_ERROR << "Fleet read error: " << e.what();
+                sendError(callback, k500InternalServerError, e.what());
+            }
+        };
+
+        // Запись с числом итераций, для которого ключ еще не выведен
+        // (PBKDF2): расшифровка в пуле, а не в IO-потоке
+        if (!keys_->hasKey(static_cast<int>(header.iterations))) {
+            auto shared = std::make_shared<std::function<void(const HttpResponsePtr&)>>(std::move(callback));
+            if (!pool_->trySubmit([respond = std::move(respond), shared]() mutable { respond(*shared); })) {
+                sendBusy(*shared);
+            }
+            return;
+        }
+        respond(callback);
+    } catch (const std::exception& e) {
+        LOG_ERROR << "Fleet read error: " << e.what();
+        sendError(callback, k500InternalServerError, e.what());
+    }
+}
+
+// Изменение разрешенных полей записи (PATCH /car/{vin}/update).
+// Чтение-изменение-запись выполняется в пуле (расшифровка, fdatasync).
+void FleetController::updateCar(
+    const HttpRequestPtr& req,
+    std::function<void(const HttpResponsePtr&)>&& callback,
+    const std::string& vin
+) {
+    auto json = req->getJsonObject();
+    if (!json) {
+        sendError(callback, k400BadRequest, "Invalid JSON");
+        return;
+    }
+
+    auto shared = std::make_shared<std::function<void(const HttpResponsePtr&)>>(std::move(callback));
+    const bool queued = pool_->trySubmit([this, json, vin, shared] {
+        auto& callback = *shared;
+        try {
+            std::lock_guard<std::mutex> lock(updateMutex_);
+            std::string record;
+            if (!store_->get(vin, record)) {
+                sendError(callback, k404NotFound, "Car not found");
+                return;
+            }
+
+            CarDetails details;
+            openRecord(record, details);
+            applyCarPatch(*json, details);
+
+            // Дозапись новой версии: файл целиком не перезаписывается
+            store_->put(vin, sealRecord(details));
+
+            Json::Value response;
+            response["status"] = "Update successful";
+            callback(HttpResponse::newHttpJsonResponse(response));
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Fleet update error: " << e.what();
+            sendError(callback, k400BadRequest, e.what());
+        }
+    });
+    if (!queued) sendBusy(*shared);
+}
+
+// Разбор тела пакетного запроса: JSON-массив или NDJSON
+std::shared_ptr<FleetController::BatchJob> FleetController::parseBatch(const HttpRequestPtr& req) {
+    auto job = std::make_shared<BatchJob>();
+    job->req = req;
+    job->ndjson = req->getHeader("Content-Type").find("ndjson") != std::string::npos;
+
+    if (job->ndjson) {
+        // Разбиение на строки без копирования; сам JSON разбирается в пуле
+        std::string_view body = req->getBody();
+        while (!body.empty()) {
+            size_t end = body.find('\n');
+            std::string_view line = body.substr(0, end);
+            body.remove_prefix(end == std::string_view::npos ? body.size() : end + 1);
+
+            while (!line.empty() && isspace(static_cast<unsigned char>(line.back()))) line.remove_suffix(1);
+            while (!line.empty() && isspace(static_cast<unsigned char>(line.front()))) line.remove_prefix(1);
+            if (!line.empty()) job->lines.push_back(line);
+        }
+    } else {
+        job->array = req->getJsonObject();
+        if (!job->array || !job->array->isArray()) {
+            throw std::invalid_argument("Expected JSON array or NDJSON body");
+        }
+    }
+
+    const size_t count = job->size();
+    if (count == 0) throw std::invalid_argument("Empty batch");
+    if (count > kMaxBatchItems) throw std::length_error("Batch too large");
+
+    job->vins.resize(count);
+    job->values.resize(count);
+    job->errors.resize(count);
+    return job;
+}
+
+// Пакетное создание записей (POST /car/batch).
+// Разбор, валидация и шифрование выполняются параллельно в пуле,
+// запись новых VIN — одной пачкой журнала.
+void FleetController::createBatch(
+    const HttpRequestPtr& req,
+    std::function<void(const HttpResponsePtr&)>&& callback
+) {
+    std::shared_ptr<BatchJob> job;
+    try {
+        job = parseBatch(req);
+    } catch (const std::length_error& e) {
+        sendError(callback, k413RequestEntityTooLarge, e.what());
+        return;
+    } catch (const std::exception& e) {
+        sendError(callback, k400BadRequest, e.what());
+        return;
+    }
+    job->callback = std::move(callback);
+
+    auto process = [this, job](size_t i) {
+        try {
+            Json::Value item;
+            job->item(i, item);
+            CarDetails details;
+            parseCarJson(item, details);
+            job->vins[i] = details.vin;
+            job->values[i] = sealRecord(details);
+        } catch (const std::exception& e) {
+            job->errors[i] = e.what();
+        }
+    };
+
+    auto finish = [this, job] {
+        // Запись всех корректных элементов одним fdatasync
+        std::vector<RecordStore::Entry> entries;
+        std::vector<size_t> positions;
+        for (size_t i = 0; i < job->size(); ++i) {
+            if (!job->errors[i].empty()) continue;
+            entries.emplace_back(job->vins[i], std::move(job->values[i]));
+            positions.push_back(i);
+        }
+
+        std::vector<bool> inserted;
+        try {
+            inserted = store_->insertBatch(entries);
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Fleet batch write error: " << e.what();
+            sendError(job->callback, k500InternalServerError, e.what());
+            return;
+        }
+
+        std::vector<bool> conflict(job->size(), false);
+        size_t created = 0;
+        for (size_t k = 0; k < positions.size(); ++k) {
+            if (inserted[k]) {
+                ++created;
+            } else {
+                conflict[positions[k]] = true;
+            }
+        }
+
+        // Результат по каждому элементу в порядке запроса
+        std::string body;
+        Json::Value results(Json::arrayValue);
+        for (size_t i = 0; i < job->size(); ++i) {
+            Json::Value result;
+            result["index"] = static_cast<Json::UInt64>(i);
+            if (!job->vins[i].empty()) result["vin"] = job->vins[i];
+            if (conflict[i]) {
+                result["status"] = "conflict";
+                result["error"] = "Car already exists";
+            } else if (!job->errors[i].empty()) {
+                result["status"] = "invalid";
+                result["error"] = job->errors[i];
+            } else {
+                result["status"] = "created";
+            }
+
+            if (job->ndjson) {
+                body += writeCompactJson(result);
+                body += '\n';
+            } else {
+                results.append(std::move(result));
+            }
+        }
+
+        if (!job->ndjson) {
+            Json::Value response;
+            response["created"] = static_cast<Json::UInt64>(created);
+            response["failed"] = static_cast<Json::UInt64>(job->size() - created);
+            response["results"] = std::move(results);
+            body = writeCompactJson(response);
+        }
+        sendBatch(job->callback, std::move(body), job->ndjson);
+    };
+
+    if (!pool_->parallelFor(job->size(), std::move(process), std::move(finish))) {
+        sendBusy(job->callback);
+    }
+}
+
+// Пакетное чтение записей (POST /car/batch/read).
+// Расшифровка и сериализация каждого элемента выполняются в пуле.
+void FleetController::readBatch(
+    const HttpRequestPtr& req,
+    std::function<void(const HttpResponsePtr&)>&& callback
+) {
+    std::shared_ptr<BatchJob> job;
+    try {
+        job = parseBatch(req);
+    } catch (const std::length_error& e) {
+        sendError(callback, k413RequestEntityTooLarge, e.what());
+        return;
+    } catch (const std::exception& e) {
+        sendError(callback, k400BadRequest, e.what());
+        return;
+    }
+    job->callback = std::move(callback);
+
+    auto process = [this, job](size_t i) {
+        Json::Value result;
+        try {
+            // VIN: строка JSON или строка NDJSON без кавычек
+            if (job->ndjson && job->lines[i].front() != '"') {
+                job->vins[i] = std::string(job->lines[i]);
+            } else {
+                Json::Value item;
+                job->item(i, item);
+                if (!item.isString()) throw std::invalid_argument("VIN must be a string");
+                job->vins[i] = item.asString();
+            }
+            result["vin"] = job->vins[i];
+
+            std::string record;
+            if (!store_->get(job->vins[i], record)) {
+                result["status"] = "not_found";
+            } else {
+                CarDetails details;
+                openRecord(record, details);
+                result["status"] = "ok";
+                carToJson(details, result["car"]);
+            }
+        } catch (const std::exception& e) {
+            result["status"] = "error";
+            result["error"] = e.what();
+        }
+        job->values[i] = writeCompactJson(result);
+    };
+
+    auto finish = [job] {
+        // Склейка заранее сериализованных элементов
+        size_t total = 2;
+        for (const auto& value : job->values) total += value.size() + 1;
+
+        std::string body;
+        body.reserve(total);
+        if (!job->ndjson) body += '[';
+        for (size_t i = 0; i < job->values.size(); ++i) {
+            if (!job->ndjson && i != 0) body += ',';
+            body += job->values[i];
+            if (job->ndjson) body += '\n';
+        }
+        if (!job->ndjson) body += ']';
+        sendBatch(job->callback, std::move(body), job->ndjson);
+    };
+
+    if (!pool_->parallelFor(job->size(), std::move(process), std::move(finish))) {
+        sendBusy(job->callback);
+    }
+}
+
+// Шифрование записи текущим ключом
+std::string FleetController::sealRecord(const CarDetails& details) {
+    car_record::Record record;
+    const int iterations = keys_->iterations();
+    keys_->withKeyFor(iterations, [&](const unsigned char* key) {
+        car_record::seal(details, key, static_cast<uint32_t>(iterations), record);
+    });
+    return std::string(reinterpret_cast<const char*>(record.data()), record.size());
+}
+
+// Проверка и расшифровка записи
+void FleetController::openRecord(const std::string& record, CarDetails& details) {
+    const auto* data = reinterpret_cast<const unsigned char*>(record.data());
+    auto header = car_record::parseHeader(data, record.size());
+    keys_->withKeyFor(static_cast<int>(header.iterations), [&](const unsigned char* key) {
+        car_record::open(data, record.size(), key, details);
+    });
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <drogon/HttpController.h>
+#include "../../crypto/key_manager.h"
+#include "../../storage/record_store.h"
+#include "../../struct_data/car_struct.h"
+#include "../../utilities/worker_pool.h"
+#include <memory>
+#include <mutex>
+
+using namespace drogon;
+
+// Контроллер парка автомобилей: записи хранятся в журнале RecordStore
+// (ключ — VIN, значение — зашифрованная запись формата car_record)
+class FleetController : public HttpController<FleetController> {
+public:
+    FleetController(std::shared_ptr<KeyManager> keys,
+                    std::shared_ptr<RecordStore> store,
+                    std::shared_ptr<WorkerPool> pool)
+        : keys_(std::move(keys)), store_(std::move(store)), pool_(std::move(pool)) {}
+
+    static const bool isAutoCreation = false;
+
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(FleetController::createCar, "/cars", Post);
+        ADD_METHOD_TO(FleetController::getCarInfo, "/car/{vin}/info", Get);
+        ADD_METHOD_TO(FleetController::updateCar, "/car/{vin}/update", Patch);
+        ADD_METHOD_TO(FleetController::createBatch, "/car/batch", Post);
+        ADD_METHOD_TO(FleetController::readBatch, "/car/batch/read", Post);
+    METHOD_LIST_END
+
+    void createCar(
+        const HttpRequestPtr& req,
+        std::function<void(const HttpResponsePtr&)>&& callback
+    );
+
+    void getCarInfo(
+        const HttpRequestPtr& req,
+        std::function<void(const HttpResponsePtr&)>&& callback,
+        const std::string& vin
+    );
+
+    void updateCar(
+        const HttpRequestPtr& req,
+        std::function<void(const HttpResponsePtr&)>&& callback,
+        const std::string& vin
+    );
+
+    // Пакетное создание: JSON-массив или NDJSON (по объекту на строку)
+    void createBatch(
+        const HttpRequestPtr& req,
+        std::function<void(const HttpResponsePtr&)>&& callback
+    );
+
+    // Пакетное чтение: JSON-массив VIN или NDJSON (по VIN на строку)
+    void readBatch(
+        const HttpRequestPtr& req,
+        std::function<void(const HttpResponsePtr&)>&& callback
+    );
+
+private:
+    struct BatchJob;
+
+    std::shared_ptr<BatchJob> parseBatch(const HttpRequestPtr& req);
+    std::string sealRecord(const CarDetails& details);
+    void openRecord(const std::string& record, CarDetails& details);
+
+    std::shared_ptr<KeyManager> keys_;    // Ключ шифрования записей
+    std::shared_ptr<RecordStore> store_;  // Журнал записей по VIN
+    std::shared_ptr<WorkerPool> pool_;    // Пул для шифрования и записи журнала
+    std::mutex updateMutex_;              // Сериализация чтения-изменения-записи
+};
@@ -20,21 +20,71 @@ void MaintenanceController::addMaintenance(
         return;
     }
 
-    dbClient_->execSqlAsync(
-        "CALL add_maintenance($1::JSONB);",
-        [callback](const Result& result) {
+    // Запрос присоединяется к группе одновременных записей
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    commits_->submit(Json::writeString(writer, *jsonBody), [callback](const std::string& error) {
+        if (error.empty()) {
             Json::Value successResp;
             successResp["status"] = "Данные ТО успешно добавлены";
             callback(HttpResponse::newHttpJsonResponse(successResp));
-        },
-        [callback](const DrogonDbException& e) {
-            LOG_ERROR << "Ошибка добавления ТО: " << e.base().what();
-            Json::Value errorResp;
-            errorResp["error"] = e.base().what();
-            auto resp = HttpResponse::newHttpJsonResponse(errorResp);
-            resp->setStatusCode(k500InternalServerError);
-            callback(resp);
-        },
-        Json::writeString(Json::StreamWriterBuilder(), *jsonBody)
-    );
-}
\ No newline at end of file
+            return;
+        }
+        LOG_ERROR << "Ошибка добавления ТО: " << error;
+        Json::Value errorResp;
+        errorResp["error"] = error;
+        auto resp = HttpResponse::newHttpJsonResponse(errorResp);
+        resp->setStatusCode(k500InternalServerError);
+        callback(resp);
+    });
+}
+
+void MaintenanceController::ingestMaintenance(
+    const HttpRequestPtr& req,
+    RequestStreamPtr&& stream,
+    std::function<void(const HttpResponsePtr&)>&& callback
+) {
+    // callback забирается сессией только при успешном начале загрузки
+    auto session = ingest_->begin(std::move(callback));
+    if (!session) {
+        Json::Value errorResp;
+        errorResp["error"] = "Выполняется максимальное число загрузок";
+        auto resp = HttpResponse::newHttpJsonResponse(errorResp);
+        resp->setStatusCode(k503ServiceUnavailable);
+        resp->addHeader("Retry-After", "30");
+        callback(resp);
+        return;
+    }
+
+    // Тело уже получено целиком (потоковое чтение не включено)
+    if (!stream) {
+        const auto body = req->getBody();
+        session->feed(body.data(), body.size());
+        session->finish();
+        return;
+    }
+
+    stream->setStreamReader(RequestStreamReader::newReader(
+        [session](const char* data, size_t length) { session->feed(data, length); },
+        [session](std::exception_ptr ex) {
+            if (!ex) {
+                session->finish();
+                return;
+            }
+            try {
+                std::rethrow_exception(ex);
+            } catch (const std::exception& e) {
+                LOG_ERROR << "Загрузка ТО прервана: " << e.what();
+                session->abort(std::string("Чтение тела прервано: ") + e.what());
+            } catch (...) {
+                session->abort("Чтение тела прервано");
+            }
+        }));
+}
+
+void MaintenanceController::getIngestStatus(
+    const HttpRequestPtr& req,
+    std::function<void(const HttpResponsePtr&)>&& callback
+) {
+    callback(HttpResponse::newHttpJsonResponse(ingest_->status()));
+}
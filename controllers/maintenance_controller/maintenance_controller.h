@@ -1,20 +1,28 @@
 #pragma once
 #include <drogon/HttpController.h>
 #include <drogon/orm/DbClient.h>
+#include "../../db/copy_ingest.h"
+#include "../../db/group_commit.h"
+#include <drogon/RequestStream.h>
 
 using namespace drogon;
 using namespace drogon::orm;
 
 class MaintenanceController : public HttpController<MaintenanceController> {
 public:
-    explicit MaintenanceController(const DbClientPtr& dbClient) 
-        : dbClient_(dbClient) {}
+    MaintenanceController(std::shared_ptr<GroupCommit> commits,
+                          std::shared_ptr<CopyIngest> ingest)
+        : commits_(std::move(commits)), ingest_(std::move(ingest)) {}
 
     static const bool isAutoCreation = false;
 
     METHOD_LIST_BEGIN
         ADD_METHOD_TO(MaintenanceController::addMaintenance, 
             "/add-maintenance", Post);
+        ADD_METHOD_TO(MaintenanceController::ingestMaintenance,
+            "/add-maintenance/stream", Post);
+        ADD_METHOD_TO(MaintenanceController::getIngestStatus,
+            "/add-maintenance/stream", Get);
     METHOD_LIST_END
 
     void addMaintenance(
@@ -22,6 +30,20 @@ public:
         std::function<void(const HttpResponsePtr&)>&& callback
     );
 
+    // Потоковая загрузка NDJSON (тело читается по частям)
+    void ingestMaintenance(
+        const HttpRequestPtr& req,
+        RequestStreamPtr&& stream,
+        std::function<void(const HttpResponsePtr&)>&& callback
+    );
+
+    // Ход текущих и итоги недавних загрузок
+    void getIngestStatus(
+        const HttpRequestPtr& req,
+        std::function<void(const HttpResponsePtr&)>&& callback
+    );
+
 private:
-    DbClientPtr dbClient_;
-};
\ No newline at end of file
+    std::shared_ptr<GroupCommit> commits_;  // Групповая запись (сброс кэша отчетов после записи)
+    std::shared_ptr<CopyIngest> ingest_;    // Потоковая загрузка через COPY
+};
@@ -1,7 +1,8 @@
 #include "maintenance_report_controller.h"
+#include "../../utilities/utilities.h"
+#include "../../utilities/pagination.h"
 #include <drogon/drogon.h>
 #include <json/json.h>
-#include <ctime>
 
 using namespace drogon;
 using namespace drogon::orm;
@@ -10,10 +11,6 @@ void MaintenanceReportController::getMaintenanceReport(
     const HttpRequestPtr& req,
     std::function<void(const HttpResponsePtr&)>&& callback
 ) {
-    Json::StreamWriterBuilder writer;
-    writer.settings_["emitUTF8"] = true;
-    writer.settings_["indentation"] = "";
-
     try {
         const auto& params = req->getParameters();
         std::optional<std::string> start_date, end_date;
@@ -26,51 +23,48 @@ void MaintenanceReportController::getMaintenanceReport(
             end_date = params.at("end_date");
         }
 
-        // Валидация формата дат
-        std::tm tm = {};
-        if (start_date && !strptime(start_date->c_str(), "%Y-%m-%d", &tm)) {
+        // Валидация и нормализация дат
+        if (start_date && !normalizeDate(*start_date, *start_date)) {
             throw std::invalid_argument("Неверный формат start_date");
         }
-        if (end_date && !strptime(end_date->c_str(), "%Y-%m-%d", &tm)) {
+        if (end_date && !normalizeDate(*end_date, *end_date)) {
             throw std::invalid_argument("Неверный формат end_date");
         }
 
-        // Подготовка параметров для SQL
-        auto start_param = start_date.has_value() ? *start_date : "NULL";
-        auto end_param = end_date.has_value() ? *end_date : "NULL";
-
-        dbClient_->execSqlAsync(
-            "SELECT generate_maintenance_report("
-            "CASE WHEN $1::TEXT = 'NULL' THEN NULL ELSE $1::DATE END, "
-            "CASE WHEN $2::TEXT = 'NULL' THEN NULL ELSE $2::DATE END"
-            ") as report;",
-            [callback, writer](const Result& result) mutable {
-                if (!result.empty()) {
-                    auto reportJson = result[0]["report"].as<Json::Value>();
-                    auto resp = HttpResponse::newHttpResponse();
-                    resp->setBody(Json::writeString(writer, reportJson));
-                    resp->setContentTypeCodeAndCustomString(
-                        CT_APPLICATION_JSON,
-                        "application/json; charset=utf-8"
-                    );
+        // Постраничный режим (limit/cursor): страница — limit дат ТО,
+        // начиная с самых новых; отчет строится только по этим датам
+        const PageRequest page = parsePageRequest(req);
+        if (page.enabled) {
+            db_->execAsync(
+                StatementId::MaintenanceReportPage,
+                [callback, format = negotiateBinaryFormat(req->getHeader("Accept"))](
+                    const Result& result) {
+                    callback(newPageResponse("report", result[0], format));
+                },
+                [callback](const DrogonDbException& e) {
+                    LOG_ERROR << "Ошибка страницы отчета ТО: " << e.base().what();
+                    Json::Value errorResp;
+                    errorResp["error"] = "Ошибка генерации отчета";
+                    auto resp = HttpResponse::newHttpJsonResponse(errorResp);
+                    resp->setStatusCode(k500InternalServerError);
                     callback(resp);
-                } else {
-                    Json::Value error;
-                    error["error"] = "Данные не найдены";
-                    callback(HttpResponse::newHttpJsonResponse(error));
-                }
-            },
-            [callback](const DrogonDbException& e) {
-                LOG_ERROR << "Ошибка отчета: " << e.base().what();
-                Json::Value errorResp;
-                errorResp["error"] = "Ошибка генерации отчета";
-                auto resp = HttpResponse::newHttpJsonResponse(errorResp);
-                resp->setStatusCode(k500InternalServerError);
-                callback(resp);
-            },
-            start_param,
-            end_param
-        );
+                },
+                start_date, end_date, page.after, page.limit
+            );
+            return;
+        }
+
+        // Отчет меняется при добавлении ТО: TTL и инвалидация по группе
+        ReportQuery query{
+            StatementId::MaintenanceReport, "report",
+            "maintenance|" + start_date.value_or("-") + "|" + end_date.value_or("-"), false,
+            kMaintenanceCacheTag,
+            "Данные не найдены",
+            "Ошибка отчета"
+        };
+
+        // Отсутствующая дата передается как NULL
+        reports_->fetch(query, req, std::move(callback), start_date, end_date);
     } catch (const std::exception& e) {
         Json::Value error;
         error["error"] = e.what();
@@ -1,13 +1,16 @@
 #pragma once
 #include <drogon/HttpController.h>
 #include <drogon/orm/DbClient.h>
+#include "../../cache/report_fetcher.h"
 
 using namespace drogon;
 using namespace drogon::orm;
 
 class MaintenanceReportController : public HttpController<MaintenanceReportController> {
 public:
-    explicit MaintenanceReportController(const DbClientPtr& dbClient) : dbClient_(dbClient) {}
+    MaintenanceReportController(std::shared_ptr<ReportFetcher> reports,
+                                std::shared_ptr<StatementRegistry> db)
+        : reports_(std::move(reports)), db_(std::move(db)) {}
 
     static const bool isAutoCreation = false;
 
@@ -22,5 +25,6 @@ public:
     );
 
 private:
-    DbClientPtr dbClient_;
+    std::shared_ptr<ReportFetcher> reports_; // Выдача отчетов через кэш
+    std::shared_ptr<StatementRegistry> db_;  // Постраничные запросы (без кэша)
 };
\ No newline at end of file
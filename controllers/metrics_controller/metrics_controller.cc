@@ -0,0 +1,26 @@
+#include "metrics_controller.h"
+#include <drogon/drogon.h>
+#include <json/json.h>
+
+using namespace drogon;
+
+// Снимок метрик (GET /metrics)
+void MetricsController::getMetrics(
+    const HttpRequestPtr& req,
+    std::function<void(const HttpResponsePtr&)>&& callback
+) {
+    Json::Value metrics;
+    metrics["statements"] = db_->metrics();
+    metrics["db_routing"] = db_->routingMetrics();
+    metrics["response_cache"] = cache_->metrics();
+    metrics["report_coalescing"] = reports_->metrics();
+    metrics["report_streams"] = streamer_->metrics();
+    metrics["node_tree"] = nodes_->metrics();
+    metrics["maintenance_group_commit"] = commits_->metrics();
+    metrics["maintenance_ingest"] = ingest_->metrics();
+    metrics["workloads"] = gate_->metrics();
+
+    auto resp = HttpResponse::newHttpJsonResponse(metrics);
+    resp->addHeader("Cache-Control", "no-store");
+    callback(resp);
+}
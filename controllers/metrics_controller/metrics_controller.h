@@ -0,0 +1,49 @@
+#pragma once
+#include <drogon/HttpController.h>
+#include "../../db/statement_registry.h"
+#include "../../cache/report_fetcher.h"
+#include "../../db/cursor_stream.h"
+#include "../../db/node_tree.h"
+#include "../../db/copy_ingest.h"
+#include "../../db/group_commit.h"
+#include "../../app_config/workload_gate.h"
+#include <memory>
+
+using namespace drogon;
+
+// Метрики сервера в формате JSON: запросы к БД и кэш отчетов
+class MetricsController : public HttpController<MetricsController> {
+public:
+    MetricsController(std::shared_ptr<StatementRegistry> db,
+                      std::shared_ptr<ResponseCache> cache,
+                      std::shared_ptr<ReportFetcher> reports,
+                      std::shared_ptr<CursorStreamer> streamer,
+                      std::shared_ptr<NodeTree> nodes,
+                      std::shared_ptr<GroupCommit> commits,
+                      std::shared_ptr<CopyIngest> ingest,
+                      std::shared_ptr<WorkloadGate> gate)
+        : db_(std::move(db)), cache_(std::move(cache)), reports_(std::move(reports)),
+          streamer_(std::move(streamer)), nodes_(std::move(nodes)),
+          commits_(std::move(commits)), ingest_(std::move(ingest)), gate_(std::move(gate)) {}
+
+    static const bool isAutoCreation = false;
+
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(MetricsController::getMetrics, "/metrics", Get);
+    METHOD_LIST_END
+
+    void getMetrics(
+        const HttpRequestPtr& req,
+        std::function<void(const HttpResponsePtr&)>&& callback
+    );
+
+private:
+    std::shared_ptr<StatementRegistry> db_; // Реестр запросов к БД
+    std::shared_ptr<ResponseCache> cache_;  // Кэш отчетов
+    std::shared_ptr<ReportFetcher> reports_; // Объединение одновременных запросов отчетов
+    std::shared_ptr<CursorStreamer> streamer_; // Потоковые отчеты
+    std::shared_ptr<NodeTree> nodes_;          // Дерево узлов
+    std::shared_ptr<GroupCommit> commits_;     // Групповая запись ТО
+    std::shared_ptr<CopyIngest> ingest_;       // Потоковая загрузка ТО
+    std::shared_ptr<WorkloadGate> gate_;       // Допуск по классам нагрузки
+};
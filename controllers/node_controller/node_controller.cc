@@ -1,45 +1,53 @@
 #include "node_controller.h"
+#include "../../utilities/json_response.h"
+#include "../../utilities/utilities.h"
 #include <drogon/drogon.h>
 #include <json/json.h>
 
 using namespace drogon;
-using namespace drogon::orm;
+
+namespace {
+// Ответ из тела снимка дерева с учетом If-None-Match
+HttpResponsePtr treeResponse(const HttpRequestPtr& req, const std::string& etag,
+                             const std::string& body) {
+    const auto& ifNoneMatch = req->getHeader("If-None-Match");
+    if (!ifNoneMatch.empty() && etagMatches(ifNoneMatch, etag)) {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k304NotModified);
+        resp->addHeader("ETag", etag);
+        resp->addHeader("Cache-Control", "no-cache");
+        return resp;
+    }
+
+    // JSON из снимка передается без разбора и пересериализации
+    auto resp = newRawJsonResponse(std::string(body));
+    resp->addHeader("ETag", etag);
+    resp->addHeader("Cache-Control", "no-cache");
+    return resp;
+}
+
+// Дерево еще не загружено (БД была недоступна при старте)
+HttpResponsePtr notLoadedResponse() {
+    Json::Value error;
+    error["error"] = "Дерево узлов еще не загружено";
+    auto resp = HttpResponse::newHttpJsonResponse(error);
+    resp->setStatusCode(k503ServiceUnavailable);
+    resp->addHeader("Retry-After", "5");
+    return resp;
+}
+}
 
 void NodeController::getAllNodes(
     const HttpRequestPtr& req,
     std::function<void(const HttpResponsePtr&)>&& callback
 ) {
-    dbClient_->execSqlAsync(
-        "SELECT get_all_nodes_json() as nodes;",
-        [callback](const Result& result) mutable {
-            if (!result.empty()) {
-                Json::StreamWriterBuilder writer;
-                writer.settings_["emitUTF8"] = true; // Включаем UTF-8
-                writer.settings_["indentation"] = ""; // Убираем отступы
-
-                auto nodesJson = result[0]["nodes"].as<Json::Value>();
-                auto resp = HttpResponse::newHttpResponse();
-                resp->setBody(Json::writeString(writer, nodesJson));
-                resp->setContentTypeCodeAndCustomString(
-                    CT_APPLICATION_JSON,
-                    "application/json; charset=utf-8" // Явно указываем кодировку
-                );
-                callback(resp);
-            } else {
-                Json::Value error;
-                error["error"] = "Nodes not found";
-                callback(HttpResponse::newHttpJsonResponse(error));
-            }
-        },
-        [callback](const DrogonDbException& e) {
-            LOG_ERROR << "Nodes error: " << e.base().what();
-            Json::Value errorResp;
-            errorResp["error"] = "Failed to get nodes";
-            auto resp = HttpResponse::newHttpJsonResponse(errorResp);
-            resp->setStatusCode(k500InternalServerError);
-            callback(resp);
-        }
-    );
+    const auto snapshot = tree_->snapshot();
+    if (!snapshot) {
+        tree_->refresh();
+        callback(notLoadedResponse());
+        return;
+    }
+    callback(treeResponse(req, snapshot->etag, snapshot->allNodes));
 }
 
 void NodeController::getSubnodesByNodeName(
@@ -50,36 +58,21 @@ void NodeController::getSubnodesByNodeName(
     // Логирование полученного параметра для отладки
     LOG_DEBUG << "Запрос подузлов для узла: " << node_name;
 
-    Json::StreamWriterBuilder writer;
-    writer.settings_["emitUTF8"] = true;
-    writer.settings_["indentation"] = "";
+    const auto snapshot = tree_->snapshot();
+    if (!snapshot) {
+        tree_->refresh();
+        callback(notLoadedResponse());
+        return;
+    }
 
-    dbClient_->execSqlAsync(
-        "SELECT get_subnodes_by_node_name_json($1) as subnodes;",
-        [callback, writer](const Result& result) mutable {
-            if (!result.empty()) {
-                auto subnodesJson = result[0]["subnodes"].as<Json::Value>();
-                auto resp = HttpResponse::newHttpResponse();
-                resp->setBody(Json::writeString(writer, subnodesJson));
-                resp->setContentTypeCodeAndCustomString(
-                    CT_APPLICATION_JSON,
-                    "application/json; charset=utf-8" // Явное указание кодировки
-                );
-                callback(resp);
-            } else {
-                Json::Value error;
-                error["error"] = "Узел не найден";
-                callback(HttpResponse::newHttpJsonResponse(error));
-            }
-        },
-        [callback](const DrogonDbException& e) {
-            LOG_ERROR << "Ошибка БД: " << e.base().what();
-            Json::Value errorResp;
-            errorResp["error"] = "Ошибка сервера";
-            auto resp = HttpResponse::newHttpJsonResponse(errorResp);
-            resp->setStatusCode(k500InternalServerError);
-            callback(resp);
-        },
-        node_name // UTF-8 строка
-    );
-}
\ No newline at end of file
+    const auto* node = snapshot->find(node_name);
+    if (!node) {
+        Json::Value error;
+        error["error"] = "Узел не найден";
+        auto resp = HttpResponse::newHttpJsonResponse(error);
+        resp->setStatusCode(k404NotFound);
+        callback(resp);
+        return;
+    }
+    callback(treeResponse(req, snapshot->etag, node->subnodes));
+}
@@ -1,13 +1,14 @@
 #pragma once
 #include <drogon/HttpController.h>
-#include <drogon/orm/DbClient.h>
+#include "../../db/node_tree.h"
 
 using namespace drogon;
-using namespace drogon::orm;
 
+// Узлы и подузлы отдаются из дерева в памяти (без обращения к БД).
+// ETag — версия дерева: условный запрос получает 304.
 class NodeController : public HttpController<NodeController> {
 public:
-    explicit NodeController(const DbClientPtr& dbClient) : dbClient_(dbClient) {}
+    explicit NodeController(std::shared_ptr<NodeTree> tree) : tree_(std::move(tree)) {}
 
     static const bool isAutoCreation = false;
 
@@ -27,5 +28,5 @@ public:
     );
 
 private:
-    DbClientPtr dbClient_;
-};
\ No newline at end of file
+    std::shared_ptr<NodeTree> tree_; // Дерево узлов в памяти
+};
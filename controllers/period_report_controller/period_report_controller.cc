@@ -1,105 +1,76 @@
 #include "period_report_controller.h"
+#include "../../utilities/utilities.h"
 #include <drogon/drogon.h>
 #include <json/json.h>
-#include <ctime>
-#include <sstream>
-#include <vector>
 #include <string>
 #include <stdexcept>
 
 using namespace drogon;
 using namespace drogon::orm;
 
-/// Преобразует вектор строк в строку, представляющую PostgreSQL-массив.
-std::string toPgArray(const std::vector<std::string>& vec)
-{
-    std::ostringstream oss;
-    oss << "{";
-    for (size_t i = 0; i < vec.size(); ++i)
-    {
-        oss << "\"" << vec[i] << "\"";
-        if (i != vec.size() - 1)
-            oss << ",";
-    }
-    oss << "}";
-    return oss.str();
-}
-
 void PeriodReportController::getPeriodReport(
     const HttpRequestPtr &req,
     std::function<void(const HttpResponsePtr &)> &&callback)
 {
-    Json::StreamWriterBuilder writer;
-    writer.settings_["emitUTF8"] = true;
-    writer.settings_["indentation"] = "";
-
     try {
-        // Парсинг параметров
-        auto params = req->getParameters();
+        // Параметры запроса (без копирования словаря)
+        const auto& params = req->getParameters();
 
         // Даты периода (обязательные параметры)
-        const auto &start_date = params["start_date"];
-        const auto &end_date = params["end_date"];
-
-        // Валидация дат
-        std::tm tm_start = {}, tm_end = {};
-        if (!strptime(start_date.c_str(), "%Y-%m-%d", &tm_start) ||
-            !strptime(end_date.c_str(), "%Y-%m-%d", &tm_end))
+        std::string start_date, end_date;
+        if (!normalizeDate(req->getParameter("start_date"), start_date) ||
+            !normalizeDate(req->getParameter("end_date"), end_date))
         {
             throw std::invalid_argument("Неверный формат даты. Используйте YYYY-MM-DD");
         }
 
         // Обработка параметра node_names (обязательный параметр)
-        if (params.find("node_names") == params.end()) {
+        auto nodeNames = params.find("node_names");
+        if (nodeNames == params.end()) {
             throw std::invalid_argument("Параметр node_names отсутствует");
         }
-        std::vector<std::string> node_names;
-        std::stringstream ss(params["node_names"]);
-        std::string item;
-        while (std::getline(ss, item, ',')) {
-            // Можно добавить удаление лишних пробелов здесь, если необходимо
-            node_names.push_back(item);
+        if (nodeNames->second.empty()) {
+            throw std::invalid_argument("Список узлов пуст. Укажите хотя бы один узел.");
         }
 
-        if (node_names.empty()) {
-            throw std::invalid_argument("Список узлов пуст. Укажите хотя бы один узел.");
+        // Имена проверяются по дереву узлов в памяти: неизвестное имя отклоняется
+        // без обращения к БД, массив имен передается в двоичном формате
+        NodeTree::Selection nodes;
+        std::string unknown;
+        if (!nodes_->resolve(nodeNames->second, nodes, unknown)) {
+            throw std::invalid_argument("Неизвестный узел: " + unknown);
         }
 
-        // Преобразуем вектор node_names в строку в формате PostgreSQL-массива
-        std::string pgArray = toPgArray(node_names);
+        // Потоковый режим (stream=ndjson|array): строки отчета читаются
+        // курсором и передаются частями, без кэша и сборки всего JSON
+        auto stream = params.find("stream");
+        if (stream != params.end()) {
+            StreamFormat format;
+            if (stream->second == "ndjson") {
+                format = StreamFormat::Ndjson;
+            } else if (stream->second == "array") {
+                format = StreamFormat::JsonArray;
+            } else {
+                throw std::invalid_argument("Параметр stream: ndjson или array");
+            }
+
+            CursorQuery query{
+                StatementId::PeriodReportCursor, StatementId::PeriodReportFetch,
+                "item", "Ошибка потокового отчета"
+            };
+            streamer_->stream(query, format, req, std::move(callback),
+                              std::move(nodes.names), start_date, end_date);
+            return;
+        }
 
-        // Выполняем SQL запрос
-        dbClient_->execSqlAsync(
-            "SELECT get_period_report($1::TEXT[], $2::DATE, $3::DATE) as report;",
-            [callback, writer](const Result &result) mutable {
-                if (!result.empty()) {
-                    auto reportJson = result[0]["report"].as<Json::Value>();
-                    auto resp = HttpResponse::newHttpResponse();
-                    resp->setBody(Json::writeString(writer, reportJson));
-                    resp->setContentTypeCodeAndCustomString(
-                        CT_APPLICATION_JSON,
-                        "application/json; charset=utf-8"
-                    );
-                    callback(resp);
-                } else {
-                    Json::Value error;
-                    error["error"] = "Данные за период не найдены";
-                    callback(HttpResponse::newHttpJsonResponse(error));
-                }
-            },
-            [callback](const DrogonDbException &e) {
-                LOG_ERROR << "Ошибка отчета: " << e.base().what();
-                Json::Value errorResp;
-                errorResp["error"] = "Ошибка генерации отчета";
-                auto resp = HttpResponse::newHttpJsonResponse(errorResp);
-                resp->setStatusCode(k500InternalServerError);
-                callback(resp);
-            },
-            // Передаём параметры: строку pgArray, start_date и end_date
-            pgArray,
-            start_date,
-            end_date
-        );
+        // Период, закончившийся до сегодняшнего дня, не меняется
+        ReportQuery query{
+            StatementId::PeriodReport, "report",
+            "period|" + start_date + "|" + end_date + "|" + nodes.key, isPastDate(end_date), "",
+            "Данные за период не найдены",
+            "Ошибка отчета"
+        };
+        reports_->fetch(query, req, std::move(callback), std::move(nodes.names), start_date, end_date);
     }
     catch (const std::exception &e) {
         Json::Value error;
@@ -1,14 +1,19 @@
 #pragma once
 #include <drogon/HttpController.h>
 #include <drogon/orm/DbClient.h>
-#include <vector>
+#include "../../cache/report_fetcher.h"
+#include "../../db/cursor_stream.h"
+#include "../../db/node_tree.h"
 
 using namespace drogon;
 using namespace drogon::orm;
 
 class PeriodReportController : public HttpController<PeriodReportController> {
 public:
-    explicit PeriodReportController(const DbClientPtr& dbClient) : dbClient_(dbClient) {}
+    PeriodReportController(std::shared_ptr<ReportFetcher> reports,
+                           std::shared_ptr<CursorStreamer> streamer,
+                           std::shared_ptr<NodeTree> nodes)
+        : reports_(std::move(reports)), streamer_(std::move(streamer)), nodes_(std::move(nodes)) {}
 
     static const bool isAutoCreation = false;
 
@@ -23,5 +28,7 @@ public:
     );
 
 private:
-    DbClientPtr dbClient_;
+    std::shared_ptr<ReportFetcher> reports_; // Выдача отчетов через кэш
+    std::shared_ptr<CursorStreamer> streamer_; // Потоковая выдача больших отчетов
+    std::shared_ptr<NodeTree> nodes_;    // Проверка имен узлов до запроса к БД
 };
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "report_controller.h"
+#include "../../utilities/utilities.h"
 #include <drogon/drogon.h>
 #include <json/json.h>
-#include <ctime>
 
 using namespace drogon;
 using namespace drogon::orm;
@@ -12,46 +12,21 @@ void ReportController::getNodeReport(
     const std::string& node_name,
     const std::string& date_str
 ) {
-    Json::StreamWriterBuilder writer;
-    writer.settings_["emitUTF8"] = true;
-    writer.settings_["indentation"] = "";                       
-
     try {
-        // Проверка формата даты
-        std::tm tm = {};
-        if (!strptime(date_str.c_str(), "%Y-%m-%d", &tm)) {
+        // Проверка и нормализация даты
+        std::string date;
+        if (!normalizeDate(date_str, date)) {
             throw std::invalid_argument("Неверный формат даты. Используйте YYYY-MM-DD");
         }
 
-        dbClient_->execSqlAsync(
-            "SELECT get_node_report($1, $2::DATE) as report;",
-            [callback, writer](const Result& result) mutable {
-                if (!result.empty()) {
-                    auto reportJson = result[0]["report"].as<Json::Value>();
-                    auto resp = HttpResponse::newHttpResponse();
-                    resp->setBody(Json::writeString(writer, reportJson));
-                    resp->setContentTypeCodeAndCustomString(
-                        CT_APPLICATION_JSON,
-                        "application/json; charset=utf-8"
-                    );
-                    callback(resp);
-                } else {
-                    Json::Value error;
-                    error["error"] = "Данные отсутствуют";
-                    callback(HttpResponse::newHttpJsonResponse(error));
-                }
-            },
-            [callback](const DrogonDbException& e) {
-                LOG_ERROR << "Ошибка отчета: " << e.base().what();
-                Json::Value errorResp;
-                errorResp["error"] = "Ошибка генерации отчета";
-                auto resp = HttpResponse::newHttpJsonResponse(errorResp);
-                resp->setStatusCode(k500InternalServerError);
-                callback(resp);
-            },
-            node_name,
-            date_str
-        );
+        // Имя узла — последний компонент ключа, поэтому ключ однозначен
+        ReportQuery query{
+            StatementId::NodeReport, "report",
+            "node|" + date + "|" + node_name, isPastDate(date), "",
+            "Данные отсутствуют",
+            "Ошибка отчета"
+        };
+        reports_->fetch(query, req, std::move(callback), node_name, date);
     } catch (const std::exception& e) {
         Json::Value error;
         error["error"] = e.what();
@@ -59,4 +34,4 @@ void ReportController::getNodeReport(
         resp->setStatusCode(k400BadRequest);
         callback(resp);
     }
-}
\ No newline at end of file
+}
@@ -1,6 +1,5 @@
 #include "service_controller.h"
 #include <drogon/drogon.h>
-#include <json/json.h>
 
 using namespace drogon;
 using namespace drogon::orm;
@@ -9,35 +8,15 @@ void ServiceController::getRemainingServiceKm(
     const HttpRequestPtr& req,
     std::function<void(const HttpResponsePtr&)>&& callback
 ) {
-    Json::StreamWriterBuilder writer;
-    writer.settings_["emitUTF8"] = true;
-    writer.settings_["indentation"] = "";
-
-    dbClient_->execSqlAsync(
-        "SELECT calculate_remaining_service_km() as result;",
-        [callback, writer](const Result& result) mutable {
-            if (!result.empty()) {
-                auto reportJson = result[0]["result"].as<Json::Value>();
-                auto resp = HttpResponse::newHttpResponse();
-                resp->setBody(Json::writeString(writer, reportJson));
-                resp->setContentTypeCodeAndCustomString(
-                    CT_APPLICATION_JSON,
-                    "application/json; charset=utf-8"
-                );
-                callback(resp);
-            } else {
-                Json::Value error;
-                error["error"] = "Данные о пробеге недоступны";
-                callback(HttpResponse::newHttpJsonResponse(error));
-            }
-        },
-        [callback](const DrogonDbException& e) {
-            LOG_ERROR << "Ошибка запроса пробега: " << e.base().what();
-            Json::Value errorResp;
-            errorResp["error"] = "Ошибка сервера при расчете пробега";
-            auto resp = HttpResponse::newHttpJsonResponse(errorResp);
-            resp->setStatusCode(k500InternalServerError);
-            callback(resp);
-        }
-    );
+    // Пробег меняется с каждой поездкой: без кэша, только объединение
+    // одновременных запросов в один запрос к БД
+    ReportQuery query{
+        StatementId::RemainingServiceKm, "result",
+        "remaining_km", false, "",
+        "Данные о пробеге недоступны",
+        "Ошибка запроса пробега",
+        "Ошибка сервера при расчете пробега",
+        false
+    };
+    reports_->fetch(query, req, std::move(callback));
 }
\ No newline at end of file
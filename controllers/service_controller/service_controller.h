@@ -1,13 +1,14 @@
 #pragma once
 #include <drogon/HttpController.h>
 #include <drogon/orm/DbClient.h>
+#include "../../cache/report_fetcher.h"
 
 using namespace drogon;
 using namespace drogon::orm;
 
 class ServiceController : public HttpController<ServiceController> {
 public:
-    explicit ServiceController(const DbClientPtr& dbClient) : dbClient_(dbClient) {}
+    explicit ServiceController(std::shared_ptr<ReportFetcher> reports) : reports_(std::move(reports)) {}
 
     static const bool isAutoCreation = false;
 
@@ -22,5 +23,5 @@ public:
     );
 
 private:
-    DbClientPtr dbClient_;
+    std::shared_ptr<ReportFetcher> reports_; // Выдача результатов хранимых функций
 };
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "crypto_engine.h"
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <zlib.h>
+#include <stdexcept>
+
+namespace crypto_engine {
+
+namespace {
+
+// Однократный запрос реализаций у провайдера по умолчанию
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+struct Algorithms {
+    EVP_CIPHER* gcm = EVP_CIPHER_fetch(nullptr, "AES-256-GCM", nullptr);
+    EVP_CIPHER* cbc = EVP_CIPHER_fetch(nullptr, "AES-256-CBC", nullptr);
+    EVP_MD* sha256 = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+
+    Algorithms() {
+        if (!gcm || !cbc || !sha256) {
+            throw std::runtime_error("OpenSSL algorithm fetch failed");
+        }
+    }
+    ~Algorithms() {
+        EVP_CIPHER_free(gcm);
+        EVP_CIPHER_free(cbc);
+        EVP_MD_free(sha256);
+    }
+};
+#else
+struct Algorithms {
+    const EVP_CIPHER* gcm = EVP_aes_256_gcm();
+    const EVP_CIPHER* cbc = EVP_aes_256_cbc();
+    const EVP_MD* sha256 = EVP_sha256();
+};
+#endif
+
+const Algorithms& algorithms() {
+    static const Algorithms instance;
+    return instance;
+}
+
+// Контексты текущего потока. Каждый привязан к одному алгоритму и
+// направлению, поэтому между вызовами меняются только ключ и IV.
+// Расписание ключа остается в контексте до завершения потока и
+// обнуляется OpenSSL при освобождении.
+struct ThreadContexts {
+    EVP_CIPHER_CTX* gcmSeal = EVP_CIPHER_CTX_new();
+    EVP_CIPHER_CTX* gcmOpen = EVP_CIPHER_CTX_new();
+    EVP_CIPHER_CTX* cbcDecrypt = EVP_CIPHER_CTX_new();
+    EVP_MD_CTX* sha256 = EVP_MD_CTX_new();
+
+    ThreadContexts() {
+        const auto& algs = algorithms();
+        bool ok = gcmSeal && gcmOpen && cbcDecrypt && sha256
+            && EVP_EncryptInit_ex(gcmSeal, algs.gcm, nullptr, nullptr, nullptr) == 1
+            && EVP_CIPHER_CTX_ctrl(gcmSeal, EVP_CTRL_GCM_SET_IVLEN, kGcmNonceSize, nullptr) == 1
+            && EVP_DecryptInit_ex(gcmOpen, algs.gcm, nullptr, nullptr, nullptr) == 1
+            && EVP_CIPHER_CTX_ctrl(gcmOpen, EVP_CTRL_GCM_SET_IVLEN, kGcmNonceSize, nullptr) == 1
+            && EVP_DecryptInit_ex(cbcDecrypt, algs.cbc, nullptr, nullptr, nullptr) == 1
+            && EVP_DigestInit_ex(sha256, algs.sha256, nullptr) == 1;
+        if (!ok) {
+            release();
+            throw std::runtime_error("Crypto context initialization failed");
+        }
+    }
+    ~ThreadContexts() { release(); }
+
+    void release() {
+        EVP_CIPHER_CTX_free(gcmSeal);
+        EVP_CIPHER_CTX_free(gcmOpen);
+        EVP_CIPHER_CTX_free(cbcDecrypt);
+        EVP_MD_CTX_free(sha256);
+        gcmSeal = gcmOpen = cbcDecrypt = nullptr;
+        sha256 = nullptr;
+    }
+};
+
+ThreadContexts& contexts() {
+    thread_local ThreadContexts instance;
+    return instance;
+}
+
+} // namespace
+
+// SHA-256 с повторно используемым контекстом
+void sha256(const void* data, size_t size, unsigned char* out) {
+    EVP_MD_CTX* ctx = contexts().sha256;
+    // Алгоритм уже привязан к контексту потока
+    if (EVP_DigestInit_ex(ctx, nullptr, nullptr) != 1
+        || EVP_DigestUpdate(ctx, data, size) != 1
+        || EVP_DigestFinal_ex(ctx, out, nullptr) != 1) {
+        throw std::runtime_error("SHA-256 computation failed");
+    }
+}
+
+// HMAC-SHA256 (не на горячем пути: контекст не переиспользуется)
+void hmacSha256(const unsigned char* key, size_t keySize,
+                const void* data, size_t size, unsigned char* out) {
+    if (!HMAC(EVP_sha256(), key, static_cast<int>(keySize),
+              static_cast<const unsigned char*>(data), size, out, nullptr)) {
+        throw std::runtime_error("HMAC computation failed");
+    }
+}
+
+uint32_t crc32(const void* data, size_t size) {
+    return static_cast<uint32_t>(::crc32(0, static_cast<const Bytef*>(data), static_cast<uInt>(size)));
+}
+
+// Шифрование AES-256-GCM
+void gcmSeal(const unsigned char* key, const unsigned char* nonce,
+             const unsigned char* aad, size_t aadSize,
+             const unsigned char* in, size_t size,
+             unsigned char* out, unsigned char* tag) {
+    EVP_CIPHER_CTX* ctx = contexts().gcmSeal;
+    int len = 0;
+    bool ok = EVP_EncryptInit_ex(ctx, nullptr, nullptr, key, nonce) == 1
+        && (aadSize == 0 || EVP_EncryptUpdate(ctx, nullptr, &len, aad, static_cast<int>(aadSize)) == 1)
+        && EVP_EncryptUpdate(ctx, out, &len, in, static_cast<int>(size)) == 1
+        && EVP_EncryptFinal_ex(ctx, out + len, &len) == 1
+        && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, kGcmTagSize, tag) == 1;
+    if (!ok) {
+        throw std::runtime_error("Encryption failed");
+    }
+}
+
+// Расшифровка AES-256-GCM: тег проверяется при финализации
+bool gcmOpen(const unsigned char* key, const unsigned char* nonce,
+             const unsigned char* aad, size_t aadSize,
+             const unsigned char* in, size_t size,
+             const unsigned char* tag, unsigned char* out) {
+    EVP_CIPHER_CTX* ctx = contexts().gcmOpen;
+    int len = 0;
+    bool ok = EVP_DecryptInit_ex(ctx, nullptr, nullptr, key, nonce) == 1
+        && (aadSize == 0 || EVP_DecryptUpdate(ctx, nullptr, &len, aad, static_cast<int>(aadSize)) == 1)
+        && EVP_DecryptUpdate(ctx, out, &len, in, static_cast<int>(size)) == 1
+        && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, kGcmTagSize,
+                               const_cast<unsigned char*>(tag)) == 1;
+    if (!ok) {
+        throw std::runtime_error("Decryption failed");
+    }
+    return EVP_DecryptFinal_ex(ctx, out + len, &len) == 1;
+}
+
+// Расшифровка AES-256-CBC
+size_t cbcDecrypt(const unsigned char* key, const unsigned char* iv,
+                  const unsigned char* in, size_t size,
+                  unsigned char* out, size_t capacity) {
+    if (capacity < size + kBlockSize) {
+        throw std::runtime_error("Decryption buffer too small");
+    }
+    EVP_CIPHER_CTX* ctx = contexts().cbcDecrypt;
+    int len = 0, total = 0;
+    if (EVP_DecryptInit_ex(ctx, nullptr, nullptr, key, iv) != 1
+        || EVP_DecryptUpdate(ctx, out, &len, in, static_cast<int>(size)) != 1) {
+        throw std::runtime_error("Decryption failed");
+    }
+    total = len;
+    if (EVP_DecryptFinal_ex(ctx, out + total, &len) != 1) {
+        throw std::runtime_error("Decryption finalization failed");
+    }
+    return static_cast<size_t>(total + len);
+}
+
+} // namespace crypto_engine
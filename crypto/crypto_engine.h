@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Криптографические примитивы без выделения памяти на операцию.
+// Алгоритмы (EVP_CIPHER/EVP_MD) запрашиваются у провайдера OpenSSL один раз,
+// контексты создаются один раз на поток и переинициализируются только
+// ключом и IV. Все буферы передаются вызывающей стороной.
+namespace crypto_engine {
+
+constexpr size_t kKeySize = 32;        // AES-256
+constexpr size_t kBlockSize = 16;      // Блок AES (IV режима CBC)
+constexpr size_t kGcmNonceSize = 12;   // Nonce AES-GCM
+constexpr size_t kGcmTagSize = 16;     // Тег AES-GCM
+constexpr size_t kSha256Size = 32;     // Дайджест SHA-256
+
+// SHA-256 в буфер out (kSha256Size байт)
+void sha256(const void* data, size_t size, unsigned char* out);
+
+// HMAC-SHA256 в буфер out (kSha256Size байт)
+void hmacSha256(const unsigned char* key, size_t keySize,
+                const void* data, size_t size, unsigned char* out);
+
+// CRC32 (zlib)
+uint32_t crc32(const void* data, size_t size);
+
+// AES-256-GCM: шифрование size байт in в out, aad аутентифицируется без шифрования
+void gcmSeal(const unsigned char* key, const unsigned char* nonce,
+             const unsigned char* aad, size_t aadSize,
+             const unsigned char* in, size_t size,
+             unsigned char* out, unsigned char* tag);
+
+// AES-256-GCM: расшифровка с проверкой тега; false — тег не совпал
+bool gcmOpen(const unsigned char* key, const unsigned char* nonce,
+             const unsigned char* aad, size_t aadSize,
+             const unsigned char* in, size_t size,
+             const unsigned char* tag, unsigned char* out);
+
+// AES-256-CBC с PKCS#7: расшифровка в буфер out (не меньше size + kBlockSize байт).
+// Возвращает длину открытого текста.
+size_t cbcDecrypt(const unsigned char* key, const unsigned char* iv,
+                  const unsigned char* in, size_t size,
+                  unsigned char* out, size_t capacity);
+
+} // namespace crypto_engine
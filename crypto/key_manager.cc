@@ -0,0 +1,136 @@
+#include "key_manager.h"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+// Конструктор: выделение защищенной памяти и первичный вывод ключа
+KeyManager::KeyManager(std::string_view secret, std::string_view salt, int iterations)
+    : secretSize_(secret.size()), saltSize_(salt.size()) {
+    if (secret.empty() || salt.empty()) {
+        throw std::runtime_error("Encryption secrets not configured");
+    }
+
+    // Отдельная анонимная область под ключи, секрет и соль (целое число страниц)
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t required = kKeySize * (1 + kCachedKeys) + secretSize_ + saltSize_;
+    pageSize_ = (required + page - 1) / page * page;
+    void* area = mmap(nullptr, pageSize_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) {
+        throw std::runtime_error(std::string("Key page allocation failed: ") + strerror(errno));
+    }
+    key_ = static_cast<unsigned char*>(area);
+
+    // Запрет выгрузки в swap и попадания в core-дамп.
+    // Ошибка mlock не фатальна (ограничение RLIMIT_MEMLOCK), ключ все равно обнуляется.
+    mlock(key_, pageSize_);
+    madvise(key_, pageSize_, MADV_DONTDUMP);
+
+    std::memcpy(slot(kCachedKeys), secret.data(), secretSize_);
+    std::memcpy(slot(kCachedKeys) + secretSize_, salt.data(), saltSize_);
+
+    try {
+        rotate(iterations);
+    } catch (...) {
+        OPENSSL_cleanse(key_, pageSize_);
+        munlock(key_, pageSize_);
+        munmap(key_, pageSize_);
+        throw;
+    }
+}
+
+// Деструктор: обнуление ключей и секретов перед освобождением памяти
+KeyManager::~KeyManager() {
+    OPENSSL_cleanse(key_, pageSize_);
+    munlock(key_, pageSize_);
+    munmap(key_, pageSize_);
+}
+
+// Повторный вывод ключа с новым числом итераций. Прежний ключ
+// сохраняется в слоте: записи, зашифрованные до ротации, читаются без PBKDF2.
+void KeyManager::rotate(int iterations) {
+    if (iterations <= 0) {
+        throw std::runtime_error("Invalid PBKDF2 iteration count");
+    }
+
+    // Вывод выполняется вне блокировки, чтобы не задерживать читателей
+    unsigned char fresh[kKeySize];
+    bool known = false;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (const unsigned char* key = findKey(iterations)) {
+            std::memcpy(fresh, key, kKeySize);
+            known = true;
+        }
+    }
+    if (!known) derive(iterations, fresh);
+
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (iterations_ != 0 && iterations_ != iterations) rememberLocked(iterations_, key_);
+        std::memcpy(key_, fresh, kKeySize);
+        iterations_ = iterations;
+    }
+    OPENSSL_cleanse(fresh, sizeof(fresh));
+}
+
+bool KeyManager::hasKey(int iterations) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return findKey(iterations) != nullptr;
+}
+
+const unsigned char* KeyManager::findKey(int iterations) const {
+    if (iterations == iterations_) return key_;
+    for (size_t i = 0; i < kCachedKeys; ++i) {
+        if (slotIterations_[i] == iterations) return slot(i);
+    }
+    return nullptr;
+}
+
+void KeyManager::remember(int iterations, const unsigned char* key) const {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!findKey(iterations)) rememberLocked(iterations, key);
+}
+
+void KeyManager::rememberLocked(int iterations, const unsigned char* key) const {
+    for (size_t i = 0; i < kCachedKeys; ++i) {
+        if (slotIterations_[i] == iterations) {
+            std::memcpy(slot(i), key, kKeySize);
+            return;
+        }
+    }
+    const size_t index = nextSlot_;
+    nextSlot_ = (nextSlot_ + 1) % kCachedKeys;
+    std::memcpy(slot(index), key, kKeySize);
+    slotIterations_[index] = iterations;
+}
+
+// Текущее число итераций PBKDF2
+int KeyManager::iterations() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return iterations_;
+}
+
+// Временный ключ для нестандартного числа итераций
+KeyManager::KeyBuffer::KeyBuffer(const KeyManager& owner, int iterations) {
+    owner.derive(iterations, key);
+}
+
+KeyManager::KeyBuffer::~KeyBuffer() {
+    OPENSSL_cleanse(key, sizeof(key));
+}
+
+// Вывод ключа с использованием PBKDF2-HMAC-SHA256
+void KeyManager::derive(int iterations, unsigned char* out) const {
+    if (PKCS5_PBKDF2_HMAC(
+        reinterpret_cast<const char*>(secret()), static_cast<int>(secretSize_),
+        salt(), static_cast<int>(saltSize_),
+        iterations, EVP_sha256(), kKeySize, out) != 1) {
+        throw std::runtime_error("Key derivation failed");
+    }
+}
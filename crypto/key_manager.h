@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+// Менеджер ключа шифрования данных автомобиля.
+// Ключ выводится через PBKDF2 один раз (при старте или явной ротации)
+// и хранится в заблокированной странице памяти (mlock), которая
+// исключается из core-дампов и обнуляется при уничтожении объекта.
+// Ключи для других чисел итераций (записи, зашифрованные до ротации)
+// выводятся один раз и хранятся в той же странице (до kCachedKeys).
+// Секрет и соль для повторного вывода тоже копируются только в эту
+// страницу, без промежуточных строк в куче.
+class KeyManager {
+public:
+    static constexpr size_t kKeySize = 32;    // Размер ключа AES-256
+    static constexpr size_t kCachedKeys = 8;  // Ключи для прежних чисел итераций
+
+    KeyManager(std::string_view secret, std::string_view salt, int iterations);
+    ~KeyManager();
+
+    KeyManager(const KeyManager&) = delete;
+    KeyManager& operator=(const KeyManager&) = delete;
+
+    // Повторный вывод ключа (например, при смене числа итераций).
+    // PBKDF2 занимает заметное время: вызывать вне IO-потоков.
+    void rotate(int iterations);
+
+    // Текущее число итераций PBKDF2
+    int iterations() const;
+
+    // Ключ для числа итераций уже выведен (withKeyFor не запустит PBKDF2)
+    bool hasKey(int iterations) const;
+
+    // Передача ключа в функцию шифрования без копирования.
+    // Функция вызывается под разделяемой блокировкой, чтобы ротация
+    // не могла заменить ключ во время использования.
+    template <typename Fn>
+    auto withKey(Fn&& fn) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return fn(static_cast<const unsigned char*>(key_));
+    }
+
+    // Ключ для записи, зашифрованной с другим числом итераций
+    // (старые файлы после ротации). Ключ выводится при первом обращении
+    // и запоминается; следующие записи с тем же числом итераций его не выводят.
+    template <typename Fn>
+    auto withKeyFor(int iterations, Fn&& fn) const {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            if (const unsigned char* key = findKey(iterations)) {
+                return fn(key);
+            }
+        }
+        KeyBuffer temporary(*this, iterations);
+        remember(iterations, temporary.key);
+        return fn(static_cast<const unsigned char*>(temporary.key));
+    }
+
+private:
+    // Временный ключ, обнуляемый при выходе из области видимости
+    struct KeyBuffer {
+        KeyBuffer(const KeyManager& owner, int iterations);
+        ~KeyBuffer();
+        unsigned char key[kKeySize];
+    };
+
+    void derive(int iterations, unsigned char* out) const;
+
+    // Ключ для числа итераций: текущий или сохраненный (под mutex_); nullptr — нет
+    const unsigned char* findKey(int iterations) const;
+
+    // Сохранение ключа в свободный или самый старый слот
+    void remember(int iterations, const unsigned char* key) const;
+    void rememberLocked(int iterations, const unsigned char* key) const;
+
+    unsigned char* slot(size_t index) const { return key_ + kKeySize * (1 + index); }
+    const unsigned char* secret() const { return slot(kCachedKeys); }
+    const unsigned char* salt() const { return secret() + secretSize_; }
+
+    mutable std::shared_mutex mutex_; // Защита ключа от одновременной ротации
+    unsigned char* key_ = nullptr;    // Ключ в заблокированной странице (за ним — слоты, секрет, соль)
+    size_t pageSize_ = 0;             // Размер выделенной области (кратен странице)
+    size_t secretSize_ = 0;           // Длина секрета для повторного вывода ключа
+    size_t saltSize_ = 0;             // Длина соли PBKDF2
+    int iterations_ = 0;              // Число итераций PBKDF2
+
+    mutable int slotIterations_[kCachedKeys] = {};  // Число итераций ключа в слоте (0 — пусто)
+    mutable size_t nextSlot_ = 0;                   // Слот для следующего ключа
+};
@@ -0,0 +1,91 @@
+#include "openssl_enc.h"
+#include "crypto_engine.h"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr char kSaltMagic[] = "Salted__";
+constexpr size_t kSaltMagicSize = 8;
+constexpr size_t kSaltSize = 8;
+
+// Декодирование base64 с переносами строк (формат `-a`)
+std::vector<unsigned char> decodeBase64(const std::string& text) {
+    std::string compact;
+    compact.reserve(text.size());
+    for (char c : text) {
+        if (!isspace(static_cast<unsigned char>(c))) compact += c;
+    }
+    if (compact.empty() || compact.size() % 4 != 0) {
+        throw std::runtime_error("Invalid base64 length");
+    }
+
+    std::vector<unsigned char> out(compact.size() / 4 * 3);
+    int size = EVP_DecodeBlock(out.data(), reinterpret_cast<const unsigned char*>(compact.data()),
+                               static_cast<int>(compact.size()));
+    if (size < 0) {
+        throw std::runtime_error("Invalid base64 data");
+    }
+
+    // EVP_DecodeBlock учитывает дополнение '=' как нулевые байты
+    size_t padding = 0;
+    for (auto it = compact.rbegin(); it != compact.rend() && *it == '='; ++it) ++padding;
+    out.resize(static_cast<size_t>(size) - padding);
+    return out;
+}
+
+} // namespace
+
+// Расшифровка одного блока данных `openssl enc`
+std::string opensslEncDecrypt(const std::string& armored, const std::string& passphrase,
+                              int iterations) {
+    const auto data = decodeBase64(armored);
+    if (data.size() < kSaltMagicSize + kSaltSize + crypto_engine::kBlockSize
+        || std::memcmp(data.data(), kSaltMagic, kSaltMagicSize) != 0) {
+        throw std::runtime_error("Missing Salted__ header");
+    }
+    const unsigned char* salt = data.data() + kSaltMagicSize;
+    const unsigned char* ciphertext = salt + kSaltSize;
+    const size_t ciphertextSize = data.size() - kSaltMagicSize - kSaltSize;
+
+    // Ключ и IV одним выводом PBKDF2
+    unsigned char keyIv[crypto_engine::kKeySize + crypto_engine::kBlockSize];
+    if (PKCS5_PBKDF2_HMAC(passphrase.c_str(), static_cast<int>(passphrase.size()),
+                          salt, kSaltSize, iterations, EVP_sha256(),
+                          sizeof(keyIv), keyIv) != 1) {
+        throw std::runtime_error("Key derivation failed");
+    }
+
+    std::vector<unsigned char> plain(ciphertextSize + crypto_engine::kBlockSize);
+    size_t plainSize = 0;
+    try {
+        plainSize = crypto_engine::cbcDecrypt(keyIv, keyIv + crypto_engine::kKeySize,
+                                              ciphertext, ciphertextSize,
+                                              plain.data(), plain.size());
+    } catch (...) {
+        OPENSSL_cleanse(keyIv, sizeof(keyIv));
+        OPENSSL_cleanse(plain.data(), plain.size());
+        throw;
+    }
+    OPENSSL_cleanse(keyIv, sizeof(keyIv));
+
+    std::string result(reinterpret_cast<const char*>(plain.data()), plainSize);
+    OPENSSL_cleanse(plain.data(), plain.size());
+    return result;
+}
+
+// Первая строка файла пароля
+std::string readPassphraseFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open passphrase file: " + path);
+    }
+    std::string passphrase;
+    std::getline(file, passphrase);
+    return passphrase;
+}
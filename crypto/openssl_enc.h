@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+// Расшифровка данных в формате утилиты `openssl enc`
+// (эквивалент `openssl enc -d -aes-256-cbc -a -salt -pbkdf2 -iter N`):
+//   base64( "Salted__" | соль 8 байт | шифртекст AES-256-CBC )
+// Ключ и IV выводятся через PBKDF2-HMAC-SHA256 (48 байт: ключ 32 + IV 16).
+std::string opensslEncDecrypt(const std::string& armored, const std::string& passphrase,
+                              int iterations);
+
+// Чтение пароля как в `-pass file:` — первая строка файла без перевода строки
+std::string readPassphraseFile(const std::string& path);
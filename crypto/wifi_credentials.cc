@@ -0,0 +1,63 @@
+#include "wifi_credentials.h"
+#include "openssl_enc.h"
+#include "../utilities/utilities.h"
+#include <drogon/drogon.h>
+#include <openssl/crypto.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Число итераций PBKDF2, с которым setup_ap.sh шифрует файлы
+constexpr int kWifiIterations = 10000;
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+} // namespace
+
+// Конструктор: запуск фоновой расшифровки
+WifiCredentials::WifiCredentials(std::string directory)
+    : credentials_(std::async(std::launch::async, &WifiCredentials::load, std::move(directory))) {}
+
+std::pair<std::string, std::string> WifiCredentials::get() const {
+    return credentials_.get();
+}
+
+// Расшифровка SSID и пароля без запуска внешних процессов
+std::pair<std::string, std::string> WifiCredentials::load(const std::string& directory) {
+    try {
+        std::string passphrase = readPassphraseFile(directory + "/encryption_key");
+        auto decrypt = [&](const std::string& name) {
+            return trim(opensslEncDecrypt(readFile(directory + "/" + name), passphrase, kWifiIterations));
+        };
+
+        std::pair<std::string, std::string> credentials;
+        try {
+            credentials.first = decrypt("encrypted_ssid");
+            credentials.second = decrypt("encrypted_password");
+        } catch (...) {
+            OPENSSL_cleanse(&passphrase[0], passphrase.size());
+            throw;
+        }
+        OPENSSL_cleanse(&passphrase[0], passphrase.size());
+
+        // Проверка полученных данных
+        if (credentials.first.empty() || credentials.second.empty()) {
+            throw std::runtime_error("Invalid WiFi credentials");
+        }
+        LOG_INFO << "WiFi credentials loaded";
+        return credentials;
+    } catch (const std::exception& e) {
+        LOG_FATAL << "WiFi error: " << e.what();
+        throw;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <future>
+#include <string>
+#include <utility>
+
+// Учетные данные точки доступа Wi-Fi (SSID и пароль).
+// Файлы /etc/wifi_ap/* расшифровываются один раз в фоновом потоке при
+// старте сервера; обработчики запросов читают готовый результат.
+class WifiCredentials {
+public:
+    explicit WifiCredentials(std::string directory = "/etc/wifi_ap");
+
+    WifiCredentials(const WifiCredentials&) = delete;
+    WifiCredentials& operator=(const WifiCredentials&) = delete;
+
+    // SSID и пароль. До завершения загрузки вызов ждет ее окончания,
+    // ошибка загрузки пробрасывается исключением.
+    std::pair<std::string, std::string> get() const;
+
+private:
+    static std::pair<std::string, std::string> load(const std::string& directory);
+
+    std::shared_future<std::pair<std::string, std::string>> credentials_;
+};
@@ -0,0 +1,434 @@
+#include "copy_ingest.h"
+#include <libpq-fe.h>
+#include <cctype>
+#include <cstring>
+
+using namespace drogon;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kMaxReportedErrors = 100; // Ошибок записей в ответе
+constexpr size_t kRecentSessions = 8;      // Итогов в /add-maintenance/stream
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Значение поля в текстовом формате COPY (\, табуляция и \r экранируются;
+// перевода строки в записи NDJSON нет)
+void appendCopyText(std::string& out, const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        switch (data[i]) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default: out += data[i];
+        }
+    }
+}
+
+// Команда без результата; false — ошибка в error
+bool execCommand(PGconn* conn, const char* sql, std::string& error) {
+    PGresult* res = PQexec(conn, sql);
+    const bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok) error = PQresultErrorMessage(res);
+    PQclear(res);
+    return ok;
+}
+
+// Строгий разбор записи (без комментариев и хвостов после объекта)
+Json::CharReader& recordReader() {
+    thread_local std::unique_ptr<Json::CharReader> reader([] {
+        Json::CharReaderBuilder builder;
+        builder["allowComments"] = false;
+        builder["failIfExtra"] = true;
+        return builder.newCharReader();
+    }());
+    return *reader;
+}
+}
+
+CopyIngest::CopyIngest(std::shared_ptr<StatementRegistry> db, std::shared_ptr<WorkerPool> pool,
+                       std::string connectionInfo, size_t maxSessions,
+                       std::function<void()> onCommit)
+    : db_(std::move(db)), pool_(std::move(pool)), connectionInfo_(std::move(connectionInfo)),
+      maxSessions_(maxSessions), onCommit_(std::move(onCommit)) {}
+
+std::shared_ptr<CopyIngest::Session> CopyIngest::begin(Callback&& callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t active = 0;
+    for (const auto& session : active_) {
+        if (!session.expired()) ++active;
+    }
+    if (active >= maxSessions_) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto session = std::make_shared<Session>(shared_from_this(), nextId_++, std::move(callback));
+    active_.push_back(session);
+    sessions_.fetch_add(1, std::memory_order_relaxed);
+    return session;
+}
+
+void CopyIngest::finished(const Session& session, Json::Value summary) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = active_.begin(); it != active_.end();) {
+        auto current = it->lock();
+        it = (!current || current.get() == &session) ? active_.erase(it) : it + 1;
+    }
+
+    // В списке недавних — только счетчики, без итогов порций
+    summary.removeMember("batches");
+    summary.removeMember("errors");
+    recent_.push_front(std::move(summary));
+    if (recent_.size() > kRecentSessions) recent_.pop_back();
+}
+
+Json::Value CopyIngest::status() const {
+    Json::Value result;
+    result["active"] = Json::Value(Json::arrayValue);
+    result["recent"] = Json::Value(Json::arrayValue);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& weak : active_) {
+        if (auto session = weak.lock()) result["active"].append(session->progress());
+    }
+    for (const auto& summary : recent_) result["recent"].append(summary);
+    return result;
+}
+
+Json::Value CopyIngest::metrics() const {
+    Json::Value result;
+    result["sessions"] = static_cast<Json::UInt64>(sessions_.load(std::memory_order_relaxed));
+    result["rejected_busy"] = static_cast<Json::UInt64>(rejected_.load(std::memory_order_relaxed));
+    result["records"] = static_cast<Json::UInt64>(records_.load(std::memory_order_relaxed));
+    result["batches"] = static_cast<Json::UInt64>(batches_.load(std::memory_order_relaxed));
+    result["failed_batches"] = static_cast<Json::UInt64>(failed_.load(std::memory_order_relaxed));
+    return result;
+}
+
+CopyIngest::Session::Session(std::shared_ptr<CopyIngest> owner, uint64_t id, Callback&& callback)
+    : owner_(std::move(owner)), id_(id), started_(Clock::now()), callback_(std::move(callback)) {}
+
+CopyIngest::Session::~Session() {
+    if (conn_) PQfinish(conn_);
+}
+
+void CopyIngest::Session::feed(const char* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ended_ || !failure_.empty()) return;
+    bytes_ += size;
+
+    const char* end = data + size;
+    while (data < end) {
+        const char* newline = static_cast<const char*>(std::memchr(data, '\n', end - data));
+        const char* stop = newline ? newline : end;
+        const size_t length = static_cast<size_t>(stop - data);
+
+        if (!skippingLine_) {
+            if (partial_.size() + length > kIngestMaxLineBytes) {
+                // Слишком длинная запись: остаток до '\n' пропускается
+                ++line_;
+                rejectLine("Запись длиннее " + std::to_string(kIngestMaxLineBytes) + " байт");
+                partial_.clear();
+                skippingLine_ = true;
+            } else if (newline && partial_.empty()) {
+                // Запись целиком во фрагменте: проверка без копирования
+                ++line_;
+                acceptLine(data, length);
+            } else {
+                partial_.append(data, length);
+                if (newline) {
+                    ++line_;
+                    acceptLine(partial_.data(), partial_.size());
+                    partial_.clear();
+                }
+            }
+        }
+        if (newline) skippingLine_ = false;
+        data = newline ? newline + 1 : end;
+    }
+
+    // Тело приходит быстрее, чем БД принимает порции: чтение не приостановить,
+    // поэтому загрузка прерывается, а не растет в памяти
+    if (queuedBytes_ > kIngestMaxQueuedBytes) {
+        failure_ = "Загрузка прервана: БД не успевает принимать порции";
+        queue_.clear();
+        queuedBytes_ = 0;
+        batch_ = Batch{};
+    }
+    schedule();
+}
+
+void CopyIngest::Session::finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ended_) return;
+    if (failure_.empty()) {
+        // Последняя запись может быть без завершающего '\n'
+        if (!skippingLine_ && !partial_.empty()) {
+            ++line_;
+            acceptLine(partial_.data(), partial_.size());
+            partial_.clear();
+        }
+        closeBatch();
+    }
+    ended_ = true;
+    schedule();
+}
+
+void CopyIngest::Session::abort(const std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (failure_.empty()) failure_ = reason;
+    queue_.clear();
+    queuedBytes_ = 0;
+    batch_ = Batch{};
+    ended_ = true;
+    schedule();
+}
+
+// Проверка записи и добавление в порцию (под mutex_)
+void CopyIngest::Session::acceptLine(const char* data, size_t size) {
+    if (size && data[size - 1] == '\r') --size;
+
+    // Пустые строки (в том числе последняя) не считаются записями
+    size_t first = 0;
+    while (first < size && std::isspace(static_cast<unsigned char>(data[first]))) ++first;
+    if (first == size) return;
+
+    Json::Value record;
+    std::string errs;
+    if (!recordReader().parse(data, data + size, &record, &errs)) {
+        rejectLine("Некорректный JSON: " + errs);
+        return;
+    }
+    if (!record.isObject()) {
+        rejectLine("Ожидается JSON-объект");
+        return;
+    }
+
+    if (batch_.records == 0) batch_.firstLine = line_;
+    batch_.lastLine = line_;
+    ++batch_.records;
+    batch_.rows += std::to_string(line_);
+    batch_.rows += '\t';
+    appendCopyText(batch_.rows, data, size);
+    batch_.rows += '\n';
+    ++accepted_;
+
+    if (batch_.records >= kIngestBatchRecords || batch_.rows.size() >= kIngestBatchBytes) {
+        closeBatch();
+    }
+}
+
+void CopyIngest::Session::rejectLine(const std::string& error) {
+    ++rejected_;
+    if (errors_.size() < kMaxReportedErrors) {
+        Json::Value entry;
+        entry["line"] = static_cast<Json::UInt64>(line_);
+        entry["error"] = error;
+        errors_.append(entry);
+    }
+}
+
+// Собранная порция уходит в очередь к БД (под mutex_)
+void CopyIngest::Session::closeBatch() {
+    if (batch_.records == 0) return;
+    queuedBytes_ += batch_.rows.size();
+    queue_.push_back(std::move(batch_));
+    batch_ = Batch{};
+}
+
+// Запуск следующего шага в пуле, если он не выполняется (под mutex_)
+void CopyIngest::Session::schedule() {
+    if (running_ || responded_) return;
+    if (queue_.empty() && !ended_) return;
+
+    running_ = true;
+    if (!owner_->pool_->trySubmit([self = shared_from_this()] { self->runNext(); })) {
+        // Пул рассчитан на одну задачу на сессию; переполнение — ошибка конфигурации
+        LOG_ERROR << "Очередь пула загрузки ТО переполнена";
+        running_ = false;
+        failure_ = "Пул загрузки переполнен";
+        queue_.clear();
+        queuedBytes_ = 0;
+    }
+}
+
+// Шаг в потоке пула: очередная порция или итог загрузки
+void CopyIngest::Session::runNext() {
+    Batch batch;
+    Json::Value result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+            if (!ended_) {
+                running_ = false;
+                return;
+            }
+            responded_ = true;
+        } else {
+            batch = std::move(queue_.front());
+            queue_.pop_front();
+            queuedBytes_ -= batch.rows.size();
+            result["batch"] = batches_.size() + 1;
+        }
+    }
+
+    if (batch.records == 0) {
+        complete();
+        return;
+    }
+
+    runBatch(batch, result);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (result["status"].asString() == "ok") committed_ += batch.records;
+    batches_.append(std::move(result));
+    running_ = false;
+    schedule();
+}
+
+// Порция в одной транзакции: COPY во временную таблицу и перенос
+void CopyIngest::Session::runBatch(const Batch& batch, Json::Value& result) {
+    const auto start = Clock::now();
+    auto& db = *owner_->db_;
+    std::string error;
+
+    result["first_line"] = static_cast<Json::UInt64>(batch.firstLine);
+    result["last_line"] = static_cast<Json::UInt64>(batch.lastLine);
+    result["records"] = static_cast<Json::UInt64>(batch.records);
+
+    // Соединение сессии открывается при первой порции
+    if (!conn_) {
+        conn_ = PQconnectdb(owner_->connectionInfo_.c_str());
+        if (PQstatus(conn_) != CONNECTION_OK) {
+            error = PQerrorMessage(conn_);
+            PQfinish(conn_);
+            conn_ = nullptr;
+        } else {
+            const auto createStart = Clock::now();
+            const bool ok = execCommand(conn_, StatementRegistry::sql(StatementId::IngestStagingCreate), error);
+            db.record(StatementId::IngestStagingCreate, Clock::now() - createStart, !ok);
+        }
+    }
+
+    bool began = false;
+    if (error.empty()) began = execCommand(conn_, "BEGIN", error);
+
+    if (began) {
+        const auto copyStart = Clock::now();
+        PGresult* res = PQexec(conn_, StatementRegistry::sql(StatementId::IngestStagingCopy));
+        if (PQresultStatus(res) != PGRES_COPY_IN) {
+            error = PQresultErrorMessage(res);
+            PQclear(res);
+        } else {
+            PQclear(res);
+            if (PQputCopyData(conn_, batch.rows.data(), static_cast<int>(batch.rows.size())) != 1
+                || PQputCopyEnd(conn_, nullptr) != 1) {
+                error = PQerrorMessage(conn_);
+            }
+            // Итог COPY (при ошибке передачи — тоже, чтобы освободить соединение)
+            while ((res = PQgetResult(conn_)) != nullptr) {
+                if (error.empty() && PQresultStatus(res) != PGRES_COMMAND_OK) {
+                    error = PQresultErrorMessage(res);
+                }
+                PQclear(res);
+            }
+        }
+        db.record(StatementId::IngestStagingCopy, Clock::now() - copyStart, !error.empty());
+    }
+
+    if (began && error.empty()) {
+        const auto mergeStart = Clock::now();
+        const bool ok = execCommand(conn_, StatementRegistry::sql(StatementId::IngestMerge), error);
+        db.record(StatementId::IngestMerge, Clock::now() - mergeStart, !ok);
+    }
+
+    if (began && error.empty()) {
+        execCommand(conn_, "COMMIT", error);
+    } else if (began) {
+        std::string ignored;
+        execCommand(conn_, "ROLLBACK", ignored);
+    }
+
+    // Разорванное соединение открывается заново для следующей порции
+    if (conn_ && PQstatus(conn_) != CONNECTION_OK) {
+        PQfinish(conn_);
+        conn_ = nullptr;
+    }
+
+    result["ms"] = millisSince(start);
+    if (error.empty()) {
+        result["status"] = "ok";
+        owner_->batches_.fetch_add(1, std::memory_order_relaxed);
+        owner_->records_.fetch_add(batch.records, std::memory_order_relaxed);
+        if (owner_->onCommit_) owner_->onCommit_();
+    } else {
+        LOG_ERROR << "Ошибка порции загрузки ТО (строки " << batch.firstLine << "-"
+                  << batch.lastLine << "): " << error;
+        result["status"] = "error";
+        result["error"] = error;
+        owner_->failed_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Итог загрузки (в потоке пула, после последней порции)
+void CopyIngest::Session::complete() {
+    if (conn_) {
+        PQfinish(conn_);
+        conn_ = nullptr;
+    }
+
+    Json::Value result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = summary();
+    }
+    owner_->finished(*this, result);
+
+    HttpStatusCode code = k200OK;
+    const std::string status = result["status"].asString();
+    if (status == "failed") code = k422UnprocessableEntity;
+    if (status == "empty") code = k400BadRequest;
+    auto resp = HttpResponse::newHttpJsonResponse(std::move(result));
+    resp->setStatusCode(code);
+    callback_(resp);
+}
+
+// Итог загрузки (под mutex_)
+Json::Value CopyIngest::Session::summary() const {
+    Json::Value result = progressLocked();
+    if (accepted_ == 0 && rejected_ == 0 && failure_.empty()) {
+        result["status"] = "empty";
+        result["error"] = "Нет записей";
+    } else if (failure_.empty() && rejected_ == 0 && committed_ == accepted_) {
+        result["status"] = "ok";
+    } else {
+        result["status"] = committed_ == 0 ? "failed" : "partial";
+    }
+    if (!failure_.empty()) result["error"] = failure_;
+    result["batches"] = batches_;
+    result["errors"] = errors_;
+    return result;
+}
+
+Json::Value CopyIngest::Session::progress() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return progressLocked();
+}
+
+Json::Value CopyIngest::Session::progressLocked() const {
+    Json::Value result;
+    result["id"] = static_cast<Json::UInt64>(id_);
+    result["bytes"] = static_cast<Json::UInt64>(bytes_);
+    result["lines"] = static_cast<Json::UInt64>(line_);
+    result["records"] = static_cast<Json::UInt64>(accepted_);
+    result["rejected"] = static_cast<Json::UInt64>(rejected_);
+    result["committed"] = static_cast<Json::UInt64>(committed_);
+    result["batches_done"] = batches_.size();
+    result["batches_queued"] = static_cast<Json::UInt64>(queue_.size());
+    result["elapsed_ms"] = millisSince(started_);
+    return result;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "statement_registry.h"
+#include "../utilities/worker_pool.h"
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct pg_conn; // PGconn из libpq
+
+// Пределы потоковой загрузки
+constexpr size_t kIngestBatchRecords = 1000;              // Записей в порции
+constexpr size_t kIngestBatchBytes = 1024 * 1024;         // Байт в порции
+constexpr size_t kIngestMaxLineBytes = 1024 * 1024;       // Длина одной записи
+constexpr size_t kIngestMaxQueuedBytes = 8 * 1024 * 1024; // Порции, ожидающие БД
+
+// Потоковая загрузка записей ТО в формате NDJSON (одна запись — один
+// JSON-объект узла, как элемент массива /add-maintenance). Записи
+// проверяются по мере поступления тела и собираются в порции; каждая
+// порция в своей транзакции копируется (COPY FROM STDIN) во временную
+// таблицу и одним CALL add_maintenance переносится в основные таблицы.
+// COPY выполняется через libpq в отдельном соединении сессии, на потоках
+// пула, по одной порции за раз; в памяти держится не больше
+// kIngestMaxQueuedBytes данных на сессию.
+class CopyIngest : public std::enable_shared_from_this<CopyIngest> {
+public:
+    using Callback = std::function<void(const drogon::HttpResponsePtr&)>;
+    class Session;
+
+    // pool — потоки для блокирующих вызовов libpq (не меньше maxSessions);
+    // onCommit вызывается после каждой успешной порции (в потоке пула)
+    CopyIngest(std::shared_ptr<StatementRegistry> db, std::shared_ptr<WorkerPool> pool,
+               std::string connectionInfo, size_t maxSessions, std::function<void()> onCommit);
+
+    CopyIngest(const CopyIngest&) = delete;
+    CopyIngest& operator=(const CopyIngest&) = delete;
+
+    // Новая сессия; nullptr — достигнут предел одновременных загрузок.
+    // callback получает итог после завершения последней порции.
+    std::shared_ptr<Session> begin(Callback&& callback);
+
+    // Ход активных и итоги недавних загрузок
+    Json::Value status() const;
+
+    // Счетчики загрузок (для /metrics)
+    Json::Value metrics() const;
+
+private:
+    friend class Session;
+    void finished(const Session& session, Json::Value summary);
+
+    std::shared_ptr<StatementRegistry> db_;  // Учет запросов
+    std::shared_ptr<WorkerPool> pool_;       // Потоки для блокирующих вызовов libpq
+    std::string connectionInfo_;             // Строка подключения libpq
+    size_t maxSessions_;                     // Предел одновременных загрузок
+    std::function<void()> onCommit_;         // Действие после успешной порции
+
+    mutable std::mutex mutex_;
+    std::vector<std::weak_ptr<Session>> active_;  // Выполняющиеся загрузки
+    std::deque<Json::Value> recent_;              // Итоги последних загрузок
+    uint64_t nextId_ = 1;                         // Номер следующей сессии
+
+    std::atomic<uint64_t> sessions_{0};   // Начатые загрузки
+    std::atomic<uint64_t> rejected_{0};   // Отказы по пределу
+    std::atomic<uint64_t> records_{0};    // Перенесенные записи
+    std::atomic<uint64_t> batches_{0};    // Успешные порции
+    std::atomic<uint64_t> failed_{0};     // Неудачные порции
+};
+
+// Одна загрузка. feed/finish/abort вызываются из IO-потока по мере
+// чтения тела; порции выполняются в пуле строго по очереди.
+class CopyIngest::Session : public std::enable_shared_from_this<CopyIngest::Session> {
+public:
+    Session(std::shared_ptr<CopyIngest> owner, uint64_t id, Callback&& callback);
+    ~Session();
+
+    // Очередной фрагмент тела
+    void feed(const char* data, size_t size);
+
+    // Конец тела: отправка остатка и ответ после последней порции
+    void finish();
+
+    // Обрыв чтения тела: неотправленные порции отбрасываются
+    void abort(const std::string& reason);
+
+    uint64_t id() const { return id_; }
+    Json::Value progress() const;
+
+private:
+    // Порция записей в текстовом формате COPY
+    struct Batch {
+        uint64_t firstLine = 0;
+        uint64_t lastLine = 0;
+        size_t records = 0;
+        std::string rows;
+    };
+
+    void acceptLine(const char* data, size_t size);
+    void rejectLine(const std::string& error);
+    void closeBatch();
+    void schedule();
+    void runNext();
+    void runBatch(const Batch& batch, Json::Value& result);
+    void complete();
+    Json::Value summary() const;
+    Json::Value progressLocked() const;
+
+    std::shared_ptr<CopyIngest> owner_;
+    const uint64_t id_;
+    const std::chrono::steady_clock::time_point started_;
+    Callback callback_;
+    pg_conn* conn_ = nullptr;  // Соединение libpq (открывается при первой порции, только в пуле)
+
+    mutable std::mutex mutex_;
+    std::string partial_;          // Незавершенная строка из прошлого фрагмента
+    bool skippingLine_ = false;    // Пропуск слишком длинной строки до '\n'
+    uint64_t line_ = 0;            // Номер последней прочитанной строки
+    Batch batch_;                  // Собираемая порция
+    std::deque<Batch> queue_;      // Порции, ожидающие БД
+    size_t queuedBytes_ = 0;
+    bool running_ = false;         // Порция выполняется в пуле
+    bool ended_ = false;           // Тело прочитано (или чтение прервано)
+    bool responded_ = false;       // Итог отправлен
+    std::string failure_;          // Причина прерывания загрузки
+
+    uint64_t bytes_ = 0;           // Принятые байты тела
+    uint64_t accepted_ = 0;        // Корректные записи
+    uint64_t rejected_ = 0;        // Отклоненные записи
+    uint64_t committed_ = 0;       // Перенесенные записи
+    Json::Value batches_{Json::arrayValue};  // Итоги порций
+    Json::Value errors_{Json::arrayValue};   // Ошибки записей (первые kMaxReportedErrors)
+};
@@ -0,0 +1,174 @@
+#include "cursor_stream.h"
+#include <algorithm>
+
+using namespace drogon;
+
+namespace {
+// Предел неотправленных байт в буфере соединения перед чтением следующей порции
+constexpr size_t kWindowBytes = 256 * 1024;
+// Интервал проверки буфера соединения
+constexpr double kDrainPollSeconds = 0.005;
+// Клиент без прогресса дольше этого времени отключается (освобождает соединение БД)
+constexpr std::chrono::seconds kStallTimeout(30);
+}
+
+// Занятие места под поток
+bool CursorStreamer::acquire() {
+    size_t current = active_.load(std::memory_order_relaxed);
+    do {
+        if (current >= maxStreams_) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!active_.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+    started_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Освобождение места (при разрушении состояния: транзакция уже не нужна)
+void CursorStreamer::release() {
+    active_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Чтение следующей порции курсора
+void CursorStreamer::fetchNext(const StatePtr& state) {
+    state->owner->db_->execAsyncOn(
+        state->trans, state->query.fetch,
+        [state](const orm::Result& result) { onRows(state, result); },
+        [state](const orm::DrogonDbException& e) { fail(state, e.base().what()); });
+}
+
+// Форматирование порции строк
+void CursorStreamer::onRows(const StatePtr& state, const orm::Result& result) {
+    const bool array = state->format == StreamFormat::JsonArray;
+    std::string chunk;
+    for (const auto& row : result) {
+        const auto& field = row[state->query.column];
+        if (array) chunk += state->rows == 0 ? "[" : ",";
+        if (field.isNull()) {
+            chunk += "null";
+        } else {
+            chunk.append(field.c_str(), field.length());
+        }
+        if (!array) chunk += '\n';
+        ++state->rows;
+    }
+
+    // Неполная порция — курсор исчерпан
+    const bool last = result.size() < kCursorFetchRows;
+    if (last && array) chunk += state->rows == 0 ? "[]" : "]";
+
+    if (!state->stream) {
+        start(state, std::move(chunk), last);
+    } else {
+        deliver(state, chunk, last);
+    }
+}
+
+// Начало ответа после первой порции (ошибки запроса до нее дают 500)
+void CursorStreamer::start(const StatePtr& state, std::string chunk, bool last) {
+    auto callback = std::move(state->callback);
+    state->callback = nullptr;
+
+    auto resp = HttpResponse::newAsyncStreamResponse(
+        [state, chunk = std::move(chunk), last](ResponseStreamPtr stream) {
+            state->stream = std::move(stream);
+            if (auto conn = state->conn.lock()) {
+                state->baseSent = conn->bytesSent();
+                state->lastSent = state->baseSent;
+            }
+            state->lastProgress = std::chrono::steady_clock::now();
+            deliver(state, chunk, last);
+        });
+    resp->setContentTypeString(state->format == StreamFormat::Ndjson
+                                   ? "application/x-ndjson; charset=utf-8"
+                                   : "application/json; charset=utf-8");
+    resp->addHeader("Cache-Control", "no-store");
+    callback(resp);
+}
+
+// Передача порции клиенту
+void CursorStreamer::deliver(const StatePtr& state, const std::string& chunk, bool last) {
+    if (!chunk.empty() && !state->stream->send(chunk)) {
+        // Клиент отключился: состояние и транзакция освобождаются
+        state->stream.reset();
+        return;
+    }
+    state->pushed += chunk.size();
+
+    if (last) {
+        state->stream->close();
+        return;
+    }
+    waitForWindow(state);
+}
+
+// Ожидание, пока клиент примет переданные данные (обратное давление)
+void CursorStreamer::waitForWindow(const StatePtr& state) {
+    auto conn = state->conn.lock();
+    if (!conn) {
+        state->stream->close();
+        return;
+    }
+
+    const size_t sent = conn->bytesSent();
+    const size_t delivered = sent - state->baseSent;
+    const size_t pending = state->pushed - std::min(state->pushed, delivered);
+    if (pending <= kWindowBytes) {
+        fetchNext(state);
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (sent != state->lastSent) {
+        state->lastSent = sent;
+        state->lastProgress = now;
+    } else if (now - state->lastProgress > kStallTimeout) {
+        LOG_WARN << state->query.logContext << ": клиент не читает ответ, поток закрыт";
+        state->stream->close();
+        return;
+    }
+
+    conn->getLoop()->runAfter(kDrainPollSeconds, [state]() { waitForWindow(state); });
+}
+
+// Ошибка открытия или чтения курсора
+void CursorStreamer::fail(const StatePtr& state, const std::string& reason) {
+    LOG_ERROR << state->query.logContext << ": " << reason;
+
+    if (!state->stream) {
+        Json::Value errorResp;
+        errorResp["error"] = "Ошибка генерации отчета";
+        auto resp = HttpResponse::newHttpJsonResponse(errorResp);
+        resp->setStatusCode(k500InternalServerError);
+        state->callback(resp);
+        return;
+    }
+
+    // Ответ уже начат: NDJSON завершается строкой с ошибкой,
+    // JSON-массив остается незакрытым (клиент получит некорректный JSON)
+    if (state->format == StreamFormat::Ndjson) {
+        state->stream->send("{\"error\":\"Ошибка генерации отчета\"}\n");
+    }
+    state->stream->close();
+}
+
+// Превышен предел одновременных потоков
+void CursorStreamer::sendBusy(const Callback& callback) {
+    Json::Value error;
+    error["error"] = "Слишком много потоковых отчетов, повторите позже";
+    auto resp = HttpResponse::newHttpJsonResponse(error);
+    resp->setStatusCode(k503ServiceUnavailable);
+    resp->addHeader("Retry-After", "1");
+    callback(resp);
+}
+
+// Счетчики потоков
+Json::Value CursorStreamer::metrics() const {
+    Json::Value result;
+    result["active"] = static_cast<Json::UInt64>(active_.load(std::memory_order_relaxed));
+    result["started"] = static_cast<Json::UInt64>(started_.load(std::memory_order_relaxed));
+    result["rejected"] = static_cast<Json::UInt64>(rejected_.load(std::memory_order_relaxed));
+    result["max"] = static_cast<Json::UInt64>(maxStreams_);
+    return result;
+}
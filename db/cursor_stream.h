@@ -0,0 +1,120 @@
+#pragma once
+
+#include "statement_registry.h"
+#include <drogon/drogon.h>
+#include <drogon/orm/DbClient.h>
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+// Формат потокового ответа
+enum class StreamFormat {
+    JsonArray,  // Один JSON-массив, передаваемый частями (chunked)
+    Ndjson      // Один JSON-объект на строку
+};
+
+// Запросы потоковой выдачи
+struct CursorQuery {
+    StatementId declare;     // DECLARE ... CURSOR (с параметрами)
+    StatementId fetch;       // FETCH FORWARD kCursorFetchRows
+    const char* column;      // Столбец строки с готовым JSON
+    const char* logContext;  // Контекст для журнала ошибок
+};
+
+// Потоковая выдача строк серверного курсора. Курсор открывается в
+// транзакции (отдельное соединение на время ответа) и читается порциями;
+// каждая порция сразу уходит клиенту через потоковый ответ Drogon.
+// Следующая порция запрашивается, только когда в буфере соединения
+// осталось не больше kWindowBytes неотправленных байт, поэтому объем
+// памяти на ответ ограничен независимо от размера отчета.
+class CursorStreamer : public std::enable_shared_from_this<CursorStreamer> {
+public:
+    using Callback = std::function<void(const drogon::HttpResponsePtr&)>;
+
+    // maxStreams — предел одновременных потоков (каждый держит соединение БД)
+    CursorStreamer(std::shared_ptr<StatementRegistry> db, size_t maxStreams)
+        : db_(std::move(db)), maxStreams_(maxStreams) {}
+
+    template <typename... Args>
+    void stream(const CursorQuery& query, StreamFormat format,
+                const drogon::HttpRequestPtr& req, Callback&& callback, Args&&... args) {
+        if (!acquire()) {
+            sendBusy(callback);
+            return;
+        }
+
+        auto state = std::make_shared<State>(shared_from_this(), query, format,
+                                             req->getConnectionPtr(), std::move(callback));
+        db_->client(query.declare)->newTransactionAsync(
+            [state, params = std::make_tuple(std::decay_t<Args>(std::forward<Args>(args))...)](
+                const std::shared_ptr<drogon::orm::Transaction>& trans) {
+                if (!trans) {
+                    fail(state, "Не удалось открыть транзакцию");
+                    return;
+                }
+                state->trans = trans;
+                std::apply([&state, &trans](const auto&... values) {
+                    state->owner->db_->execAsyncOn(
+                        trans, state->query.declare,
+                        [state](const drogon::orm::Result&) { fetchNext(state); },
+                        [state](const drogon::orm::DrogonDbException& e) {
+                            fail(state, e.base().what());
+                        },
+                        values...);
+                }, params);
+            });
+    }
+
+    // Счетчики потоков (для /metrics)
+    Json::Value metrics() const;
+
+private:
+    // Состояние одного потокового ответа. Шаги выполняются строго по
+    // очереди (запрос порции -> отправка -> ожидание окна), поэтому
+    // состояние не требует блокировок.
+    struct State {
+        State(std::shared_ptr<CursorStreamer> owner, CursorQuery query, StreamFormat format,
+              std::weak_ptr<trantor::TcpConnection> conn, Callback callback)
+            : owner(std::move(owner)), query(query), format(format),
+              conn(std::move(conn)), callback(std::move(callback)) {}
+        ~State() { owner->release(); }
+
+        std::shared_ptr<CursorStreamer> owner;
+        CursorQuery query;
+        StreamFormat format;
+        std::weak_ptr<trantor::TcpConnection> conn;        // Соединение клиента
+        Callback callback;                                  // До начала ответа
+        std::shared_ptr<drogon::orm::Transaction> trans;    // Транзакция с курсором
+        drogon::ResponseStreamPtr stream;                   // После начала ответа
+        size_t rows = 0;                                    // Отправлено строк
+        size_t pushed = 0;                                  // Передано в поток, байт
+        size_t baseSent = 0;                                // bytesSent() в начале ответа
+        size_t lastSent = 0;                                // Для обнаружения зависшего клиента
+        std::chrono::steady_clock::time_point lastProgress;
+    };
+    using StatePtr = std::shared_ptr<State>;
+
+    static void fetchNext(const StatePtr& state);
+    static void onRows(const StatePtr& state, const drogon::orm::Result& result);
+    static void start(const StatePtr& state, std::string chunk, bool last);
+    static void deliver(const StatePtr& state, const std::string& chunk, bool last);
+    static void waitForWindow(const StatePtr& state);
+    static void fail(const StatePtr& state, const std::string& reason);
+    static void sendBusy(const Callback& callback);
+
+    bool acquire();
+    void release();
+
+    std::shared_ptr<StatementRegistry> db_;  // Реестр запросов к БД
+    const size_t maxStreams_;                // Предел одновременных потоков
+    std::atomic<size_t> active_{0};          // Активные потоки
+    std::atomic<uint64_t> started_{0};       // Принятые потоки
+    std::atomic<uint64_t> rejected_{0};      // Отклоненные из-за предела
+};
@@ -0,0 +1,163 @@
+#include "group_commit.h"
+#include "../app_config/app_settings.h"
+#include <drogon/drogon.h>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+// Склейка JSON-массивов в один без разбора: берется содержимое между
+// внешними скобками каждого массива
+std::string mergeArrays(const std::vector<const std::string*>& arrays) {
+    std::string merged = "[";
+    for (const auto* array : arrays) {
+        const size_t open = array->find('[');
+        const size_t close = array->rfind(']');
+        if (open == std::string::npos || close == std::string::npos || close <= open) continue;
+
+        // Пустой массив не добавляет элементов
+        const size_t first = array->find_first_not_of(" \t\r\n", open + 1);
+        if (first == close) continue;
+
+        if (merged.size() > 1) merged += ',';
+        merged.append(*array, open + 1, close - open - 1);
+    }
+    merged += ']';
+    return merged;
+}
+
+// Ошибка гарантирует откат группы: сервер вернул ошибку выполнения CALL.
+// При таймауте на стороне клиента, обрыве соединения (SQLSTATE 08xxx) и
+// неизвестном исходе фиксации (40003) группа могла быть записана —
+// повтор по одному записал бы данные второй раз.
+bool rolledBack(const DrogonDbException& e) {
+    const auto* sqlError = dynamic_cast<const SqlError*>(&e);
+    if (!sqlError) return false;
+    const std::string& state = sqlError->sqlState();
+    return state.size() == 5 && state.compare(0, 2, "08") != 0 && state != "40003";
+}
+}
+
+void GroupCommit::submit(std::string payload, Done done) {
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    const auto settings = currentSettings();
+    const auto window = settings ? settings->groupCommitWindow : std::chrono::milliseconds(0);
+    const size_t maxBatch = settings ? settings->groupCommitMaxBatch : 1;
+
+    std::shared_ptr<Batch> ready;
+    bool armTimer = false;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(Pending{std::move(payload), std::move(done)});
+        if (window.count() == 0 || pending_.size() >= maxBatch) {
+            // Группа заполнена (или объединение выключено): запись сразу
+            ready = std::make_shared<Batch>(std::move(pending_));
+            pending_.clear();
+            ++generation_;
+        } else if (pending_.size() == 1) {
+            // Первый запрос группы запускает окно
+            armTimer = true;
+            generation = generation_;
+        }
+    }
+
+    if (ready) {
+        execute(std::move(ready));
+    } else if (armTimer) {
+        std::weak_ptr<GroupCommit> weak = shared_from_this();
+        app().getLoop()->runAfter(std::chrono::duration<double>(window).count(), [weak, generation] {
+            if (auto self = weak.lock()) self->flush(generation);
+        });
+    }
+}
+
+// Окно истекло: запись группы, если она не ушла раньше по пределу
+void GroupCommit::flush(uint64_t generation) {
+    std::shared_ptr<Batch> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != generation_ || pending_.empty()) return;
+        ready = std::make_shared<Batch>(std::move(pending_));
+        pending_.clear();
+        ++generation_;
+    }
+    execute(std::move(ready));
+}
+
+void GroupCommit::execute(std::shared_ptr<Batch> batch) {
+    const uint64_t size = batch->size();
+    uint64_t currentMax = maxBatch_.load(std::memory_order_relaxed);
+    while (size > currentMax
+           && !maxBatch_.compare_exchange_weak(currentMax, size, std::memory_order_relaxed)) {}
+
+    if (size == 1) {
+        executeOne(std::move(batch), 0);
+        return;
+    }
+
+    std::vector<const std::string*> arrays;
+    arrays.reserve(batch->size());
+    for (const auto& pending : *batch) arrays.push_back(&pending.payload);
+
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    calls_.fetch_add(1, std::memory_order_relaxed);
+    db_->execAsync(
+        StatementId::AddMaintenance,
+        [self = shared_from_this(), batch](const Result&) {
+            if (self->onCommit_) self->onCommit_();
+            for (const auto& pending : *batch) pending.done("");
+        },
+        [self = shared_from_this(), batch](const DrogonDbException& e) {
+            if (!rolledBack(e)) {
+                // Исход неизвестен: ошибка возвращается всем запросам группы
+                LOG_ERROR << "Групповая запись ТО (" << batch->size() << " запросов): "
+                          << e.base().what() << "; исход неизвестен, повтор не выполняется";
+                for (const auto& pending : *batch) pending.done(e.base().what());
+                return;
+            }
+            // Ошибка могла быть вызвана одним запросом группы: каждый
+            // выполняется отдельно и получает свой результат
+            LOG_WARN << "Групповая запись ТО (" << batch->size() << " запросов) не выполнена: "
+                     << e.base().what() << "; выполнение по одному";
+            self->fallbacks_.fetch_add(1, std::memory_order_relaxed);
+            self->executeOne(batch, 0);
+        },
+        mergeArrays(arrays)
+    );
+}
+
+// Запросы группы по одному, по порядку поступления
+void GroupCommit::executeOne(std::shared_ptr<Batch> batch, size_t index) {
+    if (index >= batch->size()) return;
+    calls_.fetch_add(1, std::memory_order_relaxed);
+    db_->execAsync(
+        StatementId::AddMaintenance,
+        [self = shared_from_this(), batch, index](const Result&) {
+            if (self->onCommit_) self->onCommit_();
+            (*batch)[index].done("");
+            self->executeOne(batch, index + 1);
+        },
+        [self = shared_from_this(), batch, index](const DrogonDbException& e) {
+            (*batch)[index].done(e.base().what());
+            self->executeOne(batch, index + 1);
+        },
+        (*batch)[index].payload
+    );
+}
+
+Json::Value GroupCommit::metrics() const {
+    Json::Value result;
+    const auto settings = currentSettings();
+    const uint64_t requests = requests_.load(std::memory_order_relaxed);
+    const uint64_t calls = calls_.load(std::memory_order_relaxed);
+    result["window_ms"] = static_cast<Json::Int64>(settings ? settings->groupCommitWindow.count() : 0);
+    result["max_batch_size"] = static_cast<Json::UInt64>(settings ? settings->groupCommitMaxBatch : 1);
+    result["requests"] = static_cast<Json::UInt64>(requests);
+    result["calls"] = static_cast<Json::UInt64>(calls);
+    result["grouped_calls"] = static_cast<Json::UInt64>(batches_.load(std::memory_order_relaxed));
+    result["largest_batch"] = static_cast<Json::UInt64>(maxBatch_.load(std::memory_order_relaxed));
+    result["fallbacks"] = static_cast<Json::UInt64>(fallbacks_.load(std::memory_order_relaxed));
+    result["requests_per_call"] = calls ? static_cast<double>(requests) / calls : 0.0;
+    return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "statement_registry.h"
+#include <json/json.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Групповая запись /add-maintenance. Запросы, пришедшие в пределах окна
+// (group_commit_window_ms) или до предела group_commit_max_batch, объединяются:
+// массивы узлов склеиваются в один, и add_maintenance вызывается один раз —
+// одна транзакция и один проход к БД на всю группу. Если сервер отклонил
+// общий вызов (транзакция откатена), запросы группы выполняются по одному,
+// чтобы каждый клиент получил свой результат; при таймауте или обрыве
+// соединения ошибка возвращается всем запросам группы без повтора.
+// Окно и предел читаются из снимка конфигурации при каждом запросе
+// (меняются без перезапуска).
+class GroupCommit : public std::enable_shared_from_this<GroupCommit> {
+public:
+    // Результат запроса: пустая строка — успех, иначе текст ошибки БД
+    using Done = std::function<void(const std::string& error)>;
+
+    // onCommit вызывается после каждой успешной записи
+    GroupCommit(std::shared_ptr<StatementRegistry> db, std::function<void()> onCommit)
+        : db_(std::move(db)), onCommit_(std::move(onCommit)) {}
+
+    GroupCommit(const GroupCommit&) = delete;
+    GroupCommit& operator=(const GroupCommit&) = delete;
+
+    // Постановка запроса: payload — JSON-массив узлов
+    void submit(std::string payload, Done done);
+
+    // Настройки и счетчики групп (для /metrics)
+    Json::Value metrics() const;
+
+private:
+    struct Pending {
+        std::string payload;  // JSON-массив узлов
+        Done done;            // Ответ клиенту
+    };
+    using Batch = std::vector<Pending>;
+
+    void flush(uint64_t generation);
+    void execute(std::shared_ptr<Batch> batch);
+    void executeOne(std::shared_ptr<Batch> batch, size_t index);
+
+    std::shared_ptr<StatementRegistry> db_;  // Реестр запросов к БД
+    std::function<void()> onCommit_;         // Действие после записи (сброс кэша)
+
+    std::mutex mutex_;
+    Batch pending_;            // Собираемая группа
+    uint64_t generation_ = 0;  // Номер группы (таймер устаревшей группы игнорируется)
+
+    std::atomic<uint64_t> requests_{0};   // Принятые запросы
+    std::atomic<uint64_t> batches_{0};    // Групповые вызовы (больше одного запроса)
+    std::atomic<uint64_t> calls_{0};      // Все вызовы add_maintenance
+    std::atomic<uint64_t> maxBatch_{0};   // Наибольшая группа
+    std::atomic<uint64_t> fallbacks_{0};  // Группы, выполненные по одному после ошибки
+};
@@ -0,0 +1,222 @@
+#include "node_tree.h"
+#include "../crypto/crypto_engine.h"
+#include "../utilities/json_response.h"
+#include "../utilities/utilities.h"
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <stdexcept>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+// Минимальный интервал между обновлениями по неизвестному имени
+constexpr std::chrono::seconds kMissRefreshInterval(5);
+
+// OID типа text (pg_type)
+constexpr uint32_t kTextOid = 25;
+
+void appendInt32(std::vector<char>& out, uint32_t value) {
+    out.push_back(static_cast<char>(value >> 24));
+    out.push_back(static_cast<char>(value >> 16));
+    out.push_back(static_cast<char>(value >> 8));
+    out.push_back(static_cast<char>(value));
+}
+
+// Одномерный TEXT[] в двоичном формате (array_recv): сервер не разбирает
+// литерал, а значения не требуют экранирования
+std::vector<char> encodeTextArray(const std::vector<const std::string*>& items) {
+    size_t size = 20;
+    for (const auto* item : items) size += 4 + item->size();
+
+    std::vector<char> out;
+    out.reserve(size);
+    appendInt32(out, 1);                                  // Число измерений
+    appendInt32(out, 0);                                  // Флаг NULL-элементов
+    appendInt32(out, kTextOid);                           // Тип элемента
+    appendInt32(out, static_cast<uint32_t>(items.size()));// Длина измерения
+    appendInt32(out, 1);                                  // Нижняя граница
+    for (const auto* item : items) {
+        appendInt32(out, static_cast<uint32_t>(item->size()));
+        out.insert(out.end(), item->begin(), item->end());
+    }
+    return out;
+}
+
+int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+const NodeTree::Node* NodeTree::Snapshot::find(const std::string& name) const {
+    const auto it = ids.find(name);
+    return it == ids.end() ? nullptr : &nodes[it->second];
+}
+
+void NodeTree::load() {
+    install(db_->client(StatementId::NodeTree)->execSqlSync(StatementRegistry::sql(StatementId::NodeTree)));
+}
+
+// Флаги проверяются и меняются под одной блокировкой: запрос, пришедший
+// во время завершения загрузки, либо увидит ее снятой, либо будет повторен
+void NodeTree::refresh() {
+    {
+        std::lock_guard<std::mutex> lock(refreshMutex_);
+        if (refreshing_) {
+            // Изменение могло произойти после начала текущей загрузки
+            pending_ = true;
+            return;
+        }
+        refreshing_ = true;
+    }
+    startRefresh();
+}
+
+void NodeTree::startRefresh() {
+    db_->execAsync(
+        StatementId::NodeTree,
+        [self = shared_from_this()](const Result& result) {
+            try {
+                self->install(result);
+            } catch (const std::exception& e) {
+                self->failures_.fetch_add(1, std::memory_order_relaxed);
+                LOG_ERROR << "Дерево узлов не обновлено: " << e.what();
+            }
+            self->finishRefresh();
+        },
+        [self = shared_from_this()](const DrogonDbException& e) {
+            self->failures_.fetch_add(1, std::memory_order_relaxed);
+            LOG_ERROR << "Дерево узлов не обновлено: " << e.base().what();
+            self->finishRefresh();
+        }
+    );
+}
+
+void NodeTree::finishRefresh() {
+    {
+        std::lock_guard<std::mutex> lock(refreshMutex_);
+        if (!pending_) {
+            refreshing_ = false;
+            return;
+        }
+        pending_ = false;
+    }
+    // Повторная загрузка: refreshing_ остается установленным
+    startRefresh();
+}
+
+void NodeTree::listen(const std::string& connectionInfo) {
+    listener_ = DbListener::newPgListener(connectionInfo);
+    std::weak_ptr<NodeTree> weak = shared_from_this();
+    listener_->listen(kNodeTreeChannel, [weak](std::string) {
+        if (auto self = weak.lock()) {
+            self->notifications_.fetch_add(1, std::memory_order_relaxed);
+            self->refresh();
+        }
+    });
+}
+
+// Сборка снимка из результата NodeTree: строка с node_name IS NULL —
+// ответ get_all_nodes_json, остальные — подузлы узла
+void NodeTree::install(const Result& result) {
+    auto next = std::make_shared<Snapshot>();
+    bool haveAll = false;
+    for (const auto& row : result) {
+        if (row["node_name"].isNull()) {
+            next->allNodes = rawJson(row["body"]);
+            haveAll = true;
+            continue;
+        }
+        auto name = row["node_name"].as<std::string>();
+        const auto id = static_cast<NodeId>(next->nodes.size());
+        if (next->ids.emplace(name, id).second) {
+            next->nodes.push_back(Node{std::move(name), rawJson(row["body"])});
+        }
+    }
+    if (!haveAll) {
+        throw std::runtime_error("get_all_nodes_json вернула пустой результат");
+    }
+
+    // Версия содержимого: SHA-256 тел всех ответов (с длинами, чтобы
+    // границы тел не сливались); совпадает у одинаковых деревьев
+    std::string digestInput = std::to_string(next->allNodes.size()) + ':' + next->allNodes;
+    for (const auto& node : next->nodes) {
+        digestInput += std::to_string(node.name.size()) + ':' + node.name;
+        digestInput += std::to_string(node.subnodes.size()) + ':' + node.subnodes;
+    }
+    unsigned char digest[crypto_engine::kSha256Size];
+    crypto_engine::sha256(digestInput.data(), digestInput.size(), digest);
+    next->etag = makeETag(digest, sizeof(digest));
+
+    const auto prev = snapshot();
+    next->version = prev ? prev->version + 1 : 1;
+    const size_t count = next->nodes.size();
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(next)));
+    LOG_INFO << "Дерево узлов загружено: " << count << " узлов";
+}
+
+std::shared_ptr<const NodeTree::Snapshot> NodeTree::snapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+bool NodeTree::resolve(std::string_view list, Selection& selection, std::string& unknown) {
+    const auto current = snapshot();
+    if (!current) {
+        unknown.assign(list.substr(0, list.find(',')));
+        onMiss();
+        return false;
+    }
+
+    std::vector<const std::string*> names;
+    std::string name;
+    selection.ids.clear();
+    selection.key.clear();
+
+    while (true) {
+        const size_t comma = list.find(',');
+        name.assign(list.substr(0, comma));
+        const auto it = current->ids.find(name);
+        if (it == current->ids.end()) {
+            unknown = std::move(name);
+            onMiss();
+            return false;
+        }
+
+        // Ключ кэша — канонические имена: идентификаторы назначаются
+        // заново при каждой загрузке дерева
+        if (!selection.ids.empty()) selection.key += ',';
+        selection.key += current->nodes[it->second].name;
+        selection.ids.push_back(it->second);
+        names.push_back(&current->nodes[it->second].name);
+
+        if (comma == std::string_view::npos) break;
+        list.remove_prefix(comma + 1);
+    }
+
+    selection.names = encodeTextArray(names);
+    return true;
+}
+
+// Узел мог появиться после загрузки: обновление с ограничением частоты
+void NodeTree::onMiss() {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    const int64_t now = nowMillis();
+    int64_t last = lastMissRefresh_.load(std::memory_order_relaxed);
+    if (now - last >= std::chrono::milliseconds(kMissRefreshInterval).count()
+        && lastMissRefresh_.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+        refresh();
+    }
+}
+
+Json::Value NodeTree::metrics() const {
+    Json::Value result;
+    const auto current = snapshot();
+    result["nodes"] = static_cast<Json::UInt64>(current ? current->nodes.size() : 0);
+    result["version"] = static_cast<Json::UInt64>(current ? current->version : 0);
+    result["etag"] = current ? current->etag : "";
+    result["notifications"] = static_cast<Json::UInt64>(notifications_.load(std::memory_order_relaxed));
+    result["failed_refreshes"] = static_cast<Json::UInt64>(failures_.load(std::memory_order_relaxed));
+    result["unknown_name_requests"] = static_cast<Json::UInt64>(misses_.load(std::memory_order_relaxed));
+    return result;
+}
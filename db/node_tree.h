@@ -0,0 +1,97 @@
+#pragma once
+
+#include "statement_registry.h"
+#include <drogon/orm/DbListener.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Канал NOTIFY, по которому схема сообщает об изменении узлов
+inline constexpr char kNodeTreeChannel[] = "nodes_changed";
+
+// Дерево узлов в памяти: список узлов (get_all_nodes_json) и подузлы
+// каждого узла (get_subnodes_by_node_name_json) загружаются одним запросом
+// и хранятся готовым JSON-текстом. Снимок неизменяем и публикуется
+// атомарно; /nodes отвечают из памяти без обращения к БД.
+// Обновление: по NOTIFY в kNodeTreeChannel (отдельное LISTEN-соединение),
+// по таймеру и при запросе с неизвестным именем (не чаще kMissRefreshInterval).
+// Имена узлов получают плотные числовые идентификаторы (словарь для
+// проверки имен отчетов за период до обращения к БД). Идентификаторы
+// действуют только в пределах одного снимка.
+class NodeTree : public std::enable_shared_from_this<NodeTree> {
+public:
+    using NodeId = uint32_t;
+
+    // Узел с готовым телом ответа /nodes/{node_name}/subnodes
+    struct Node {
+        std::string name;      // Имя узла
+        std::string subnodes;  // JSON подузлов
+    };
+
+    // Неизменяемый снимок дерева
+    struct Snapshot {
+        std::unordered_map<std::string, NodeId> ids;  // Имя -> идентификатор
+        std::vector<Node> nodes;                      // Идентификатор -> узел
+        std::string allNodes;                         // JSON ответа /nodes
+        std::string etag;                             // Версия содержимого (ETag)
+        uint64_t version = 0;                         // Номер загрузки
+
+        const Node* find(const std::string& name) const;
+    };
+
+    // Узлы запроса, проверенные по одному снимку
+    struct Selection {
+        std::vector<NodeId> ids;        // Идентификаторы в порядке запроса
+        std::vector<char> names;        // TEXT[] в двоичном формате PostgreSQL
+        std::string key;                // Ключ кэша: имена через запятую (не зависят от загрузки)
+    };
+
+    explicit NodeTree(std::shared_ptr<StatementRegistry> db)
+        : db_(std::move(db)) {}
+
+    NodeTree(const NodeTree&) = delete;
+    NodeTree& operator=(const NodeTree&) = delete;
+
+    // Синхронная загрузка при старте; std::runtime_error при ошибке
+    void load();
+
+    // Асинхронное обновление (ошибка оставляет прежний снимок). Запрос,
+    // пришедший во время загрузки, повторяет ее после завершения.
+    void refresh();
+
+    // Подписка на NOTIFY через отдельное соединение
+    void listen(const std::string& connectionInfo);
+
+    // Текущий снимок (nullptr до первой загрузки)
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    // Разбор списка "a,b,c": true — все имена известны; иначе в unknown
+    // первое неизвестное имя и запускается обновление дерева
+    bool resolve(std::string_view list, Selection& selection, std::string& unknown);
+
+    // Размер, версия и счетчики обновлений (для /metrics)
+    Json::Value metrics() const;
+
+private:
+    void install(const drogon::orm::Result& result);
+    void startRefresh();
+    void finishRefresh();
+    void onMiss();
+
+    std::shared_ptr<StatementRegistry> db_;     // Реестр запросов к БД
+    std::shared_ptr<const Snapshot> snapshot_;  // Текущий снимок (atomic_load/atomic_store)
+    drogon::orm::DbListenerPtr listener_;       // LISTEN-соединение
+    std::mutex refreshMutex_;                   // Защита refreshing_ и pending_
+    bool refreshing_ = false;                   // Обновление уже выполняется
+    bool pending_ = false;                      // Запрошено повторное обновление
+    std::atomic<int64_t> lastMissRefresh_{0};   // Время обновления по промаху (мс, steady)
+    std::atomic<uint64_t> misses_{0};           // Запросы с неизвестными именами
+    std::atomic<uint64_t> notifications_{0};    // Полученные NOTIFY
+    std::atomic<uint64_t> failures_{0};         // Неудачные обновления
+};
@@ -0,0 +1,236 @@
+#include "statement_registry.h"
+#include <drogon/HttpAppFramework.h>
+
+namespace {
+
+struct Statement {
+    StatementId id;
+    const char* name;
+    const char* sql;
+    Workload workload = Workload::Interactive;
+    DbRole role = DbRole::Read;
+};
+
+// Число строк в тексте "FETCH FORWARD N ..." (0 — другой текст)
+constexpr size_t fetchRows(const char* sql) {
+    constexpr char prefix[] = "FETCH FORWARD ";
+    size_t i = 0;
+    for (; prefix[i] != '\0'; ++i) {
+        if (sql[i] != prefix[i]) return 0;
+    }
+    size_t rows = 0;
+    for (; sql[i] >= '0' && sql[i] <= '9'; ++i) rows = rows * 10 + static_cast<size_t>(sql[i] - '0');
+    return rows;
+}
+
+// Порция курсора потокового отчета: cursor_stream считает ответ последним,
+// если строк меньше kCursorFetchRows, поэтому числа обязаны совпадать
+constexpr char kPeriodReportFetchSql[] = "FETCH FORWARD 256 FROM period_report_rows";
+static_assert(fetchRows(kPeriodReportFetchSql) == kCursorFetchRows,
+              "period_report_fetch must fetch kCursorFetchRows rows");
+
+// Таблица запросов в порядке StatementId
+constexpr Statement kStatements[] = {
+    {StatementId::UniqueDates, "unique_dates",
+     "SELECT get_unique_dates() AS dates"},
+    // Страницы дат (новые первыми): $1 — ключ-курсор (NULL — первая страница), $2 — limit.
+    // Выбирается limit + 1 дат: лишняя означает, что есть следующая страница.
+    {StatementId::UniqueDatesPage, "unique_dates_page",
+     "WITH page AS ("
+     "  SELECT DISTINCT value::DATE AS d FROM jsonb_array_elements_text(get_unique_dates()::JSONB)"
+     "  WHERE $1::DATE IS NULL OR value::DATE < $1::DATE"
+     "  ORDER BY d DESC LIMIT $2::INT + 1),"
+     " shown AS (SELECT d FROM page ORDER BY d DESC LIMIT $2::INT) "
+     "SELECT COALESCE((SELECT json_agg(to_char(d, 'YYYY-MM-DD') ORDER BY d DESC) FROM shown), '[]'::JSON) AS items,"
+     " (SELECT to_char(min(d), 'YYYY-MM-DD') FROM shown) AS next_key,"
+     " (SELECT count(*) FROM page) > $2::INT AS has_more"},
+    {StatementId::MaintenanceDates, "maintenance_dates",
+     "SELECT get_maintenance_dates() AS maintenance_dates"},
+    {StatementId::MaintenanceDatesPage, "maintenance_dates_page",
+     "WITH page AS ("
+     "  SELECT DISTINCT value::DATE AS d FROM jsonb_array_elements_text(get_maintenance_dates()::JSONB)"
+     "  WHERE $1::DATE IS NULL OR value::DATE < $1::DATE"
+     "  ORDER BY d DESC LIMIT $2::INT + 1),"
+     " shown AS (SELECT d FROM page ORDER BY d DESC LIMIT $2::INT) "
+     "SELECT COALESCE((SELECT json_agg(to_char(d, 'YYYY-MM-DD') ORDER BY d DESC) FROM shown), '[]'::JSON) AS items,"
+     " (SELECT to_char(min(d), 'YYYY-MM-DD') FROM shown) AS next_key,"
+     " (SELECT count(*) FROM page) > $2::INT AS has_more"},
+    {StatementId::AllNodes, "all_nodes",
+     "SELECT get_all_nodes_json() AS nodes"},
+    {StatementId::Subnodes, "subnodes",
+     "SELECT get_subnodes_by_node_name_json($1::TEXT) AS subnodes"},
+    // Дерево узлов одним запросом (один снимок данных): строка с NULL в
+    // node_name — список узлов, остальные — подузлы каждого узла.
+    // Элемент списка — объект с node_name или строка с именем.
+    // Выполняется на основном сервере: NOTIFY об изменении приходит оттуда,
+    // а реплика может еще не содержать изменений.
+    {StatementId::NodeTree, "node_tree",
+     "WITH tree AS (SELECT get_all_nodes_json()::JSON AS nodes),"
+     " names AS ("
+     "  SELECT DISTINCT CASE json_typeof(e) WHEN 'string' THEN e #>> '{}' ELSE e ->> 'node_name' END AS name"
+     "  FROM tree, json_array_elements(tree.nodes) AS e) "
+     "SELECT NULL::TEXT AS node_name, nodes::TEXT AS body FROM tree "
+     "UNION ALL "
+     "SELECT name, get_subnodes_by_node_name_json(name)::TEXT FROM names WHERE name IS NOT NULL",
+     Workload::Interactive, DbRole::Write},
+    {StatementId::NodeReport, "node_report",
+     "SELECT get_node_report($1::TEXT, $2::DATE) AS report", Workload::Report},
+    {StatementId::DailyReport, "daily_report",
+     "SELECT get_daily_report($1::DATE) AS report", Workload::Report},
+    {StatementId::PeriodReport, "period_report",
+     "SELECT get_period_report($1::TEXT[], $2::DATE, $3::DATE) AS report", Workload::Report},
+    // Потоковый режим: строки отчета (по одному JSON на строку) читаются
+    // курсором в транзакции порциями по kCursorFetchRows
+    {StatementId::PeriodReportCursor, "period_report_cursor",
+     "DECLARE period_report_rows NO SCROLL CURSOR FOR "
+     "SELECT r AS item FROM get_period_report_rows($1::TEXT[], $2::DATE, $3::DATE) AS r",
+     Workload::Report},
+    {StatementId::PeriodReportFetch, "period_report_fetch",
+     kPeriodReportFetchSql, Workload::Report},
+    {StatementId::MaintenanceReport, "maintenance_report",
+     "SELECT generate_maintenance_report($1::DATE, $2::DATE) AS report", Workload::Report},
+    // Страница отчета ТО: limit дат ТО в диапазоне [$1, $2] строго до ключа $3
+    // (новые первыми); отчет строится только по диапазону дат страницы.
+    {StatementId::MaintenanceReportPage, "maintenance_report_page",
+     "WITH page AS ("
+     "  SELECT DISTINCT value::DATE AS d FROM jsonb_array_elements_text(get_maintenance_dates()::JSONB)"
+     "  WHERE ($1::DATE IS NULL OR value::DATE >= $1::DATE)"
+     "    AND ($2::DATE IS NULL OR value::DATE <= $2::DATE)"
+     "    AND ($3::DATE IS NULL OR value::DATE < $3::DATE)"
+     "  ORDER BY d DESC LIMIT $4::INT + 1),"
+     " bounds AS ("
+     "  SELECT min(d) AS first_date, max(d) AS last_date"
+     "  FROM (SELECT d FROM page ORDER BY d DESC LIMIT $4::INT) AS shown) "
+     "SELECT CASE WHEN first_date IS NOT NULL"
+     "            THEN generate_maintenance_report(first_date, last_date)::JSON END AS items,"
+     " to_char(first_date, 'YYYY-MM-DD') AS next_key,"
+     " (SELECT count(*) FROM page) > $4::INT AS has_more "
+     "FROM bounds", Workload::Report},
+    {StatementId::RemainingServiceKm, "remaining_service_km",
+     "SELECT calculate_remaining_service_km() AS result"},
+    {StatementId::AddMaintenance, "add_maintenance",
+     "CALL add_maintenance($1::JSONB)", Workload::Ingest, DbRole::Write},
+    // Потоковая загрузка ТО (libpq, отдельное соединение): порция записей
+    // копируется во временную таблицу и одним вызовом передается add_maintenance
+    {StatementId::IngestStagingCreate, "ingest_staging_create",
+     "CREATE TEMP TABLE IF NOT EXISTS maintenance_staging"
+     " (line_no BIGINT NOT NULL, record JSONB NOT NULL) ON COMMIT DELETE ROWS",
+     Workload::Ingest, DbRole::Write},
+    {StatementId::IngestStagingCopy, "ingest_staging_copy",
+     "COPY maintenance_staging (line_no, record) FROM STDIN", Workload::Ingest, DbRole::Write},
+    {StatementId::IngestMerge, "ingest_merge",
+     "CALL add_maintenance((SELECT jsonb_agg(record ORDER BY line_no) FROM maintenance_staging))",
+     Workload::Ingest, DbRole::Write},
+};
+
+static_assert(sizeof(kStatements) / sizeof(kStatements[0])
+              == static_cast<size_t>(StatementId::Count),
+              "Every StatementId needs an SQL entry");
+
+// Проверка порядка таблицы на этапе компиляции
+constexpr bool ordered() {
+    for (size_t i = 0; i < static_cast<size_t>(StatementId::Count); ++i) {
+        if (static_cast<size_t>(kStatements[i].id) != i) return false;
+    }
+    return true;
+}
+static_assert(ordered(), "kStatements must follow StatementId order");
+
+} // namespace
+
+StatementRegistry::StatementRegistry(drogon::orm::DbClientPtr primary, Pools pools,
+                                     std::string fastReader)
+    : primary_(std::move(primary)), pools_(std::move(pools)),
+      fastReader_(std::move(fastReader)) {}
+
+const char* StatementRegistry::sql(StatementId id) {
+    return kStatements[index(id)].sql;
+}
+
+const char* StatementRegistry::name(StatementId id) {
+    return kStatements[index(id)].name;
+}
+
+Workload StatementRegistry::workload(StatementId id) {
+    return kStatements[index(id)].workload;
+}
+
+DbRole StatementRegistry::role(StatementId id) {
+    return kStatements[index(id)].role;
+}
+
+drogon::orm::DbClientPtr StatementRegistry::clientFor(StatementId id) {
+    if (role(id) == DbRole::Write) {
+        primaryCalls_.fetch_add(1, std::memory_order_relaxed);
+        return primary_;
+    }
+
+    // Быстрый клиент принадлежит IO-потоку и доступен только в нем;
+    // отчеты в него не попадают, чтобы не занимать соединения коротких запросов
+    const Workload cls = workload(id);
+    auto& app = drogon::app();
+    if (cls == Workload::Interactive && !fastReader_.empty() && app.isRunning()
+        && app.getCurrentThreadIndex() < app.getThreadNum()) {
+        if (auto fast = app.getFastDbClient(fastReader_)) {
+            fastCalls_.fetch_add(1, std::memory_order_relaxed);
+            return fast;
+        }
+    }
+
+    const size_t pool = static_cast<size_t>(cls);
+    if (pools_[pool]) {
+        poolCalls_[pool].fetch_add(1, std::memory_order_relaxed);
+        return pools_[pool];
+    }
+    primaryCalls_.fetch_add(1, std::memory_order_relaxed);
+    return primary_;
+}
+
+// Учет времени завершенного вызова
+void StatementRegistry::Stats::record(Clock::duration elapsed) {
+    const uint64_t micros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    completed.fetch_add(1, std::memory_order_relaxed);
+    totalMicros.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t current = maxMicros.load(std::memory_order_relaxed);
+    while (micros > current
+           && !maxMicros.compare_exchange_weak(current, micros, std::memory_order_relaxed)) {}
+}
+
+// Счетчики в формате JSON
+Json::Value StatementRegistry::metrics() const {
+    Json::Value result(Json::objectValue);
+    for (size_t i = 0; i < stats_.size(); ++i) {
+        const auto& stats = stats_[i];
+        const uint64_t completed = stats.completed.load(std::memory_order_relaxed);
+        const uint64_t total = stats.totalMicros.load(std::memory_order_relaxed);
+
+        Json::Value entry;
+        entry["sql"] = kStatements[i].sql;
+        entry["role"] = kStatements[i].role == DbRole::Read ? "read" : "write";
+        entry["workload"] = workloadName(kStatements[i].workload);
+        entry["calls"] = static_cast<Json::UInt64>(stats.calls.load(std::memory_order_relaxed));
+        entry["errors"] = static_cast<Json::UInt64>(stats.errors.load(std::memory_order_relaxed));
+        entry["total_ms"] = total / 1000.0;
+        entry["avg_ms"] = completed ? total / 1000.0 / completed : 0.0;
+        entry["max_ms"] = stats.maxMicros.load(std::memory_order_relaxed) / 1000.0;
+        result[kStatements[i].name] = entry;
+    }
+    return result;
+}
+
+// Распределение вызовов по пулам
+Json::Value StatementRegistry::routingMetrics() const {
+    Json::Value result;
+    result["fast_read_client"] = fastReader_;
+    result["primary_calls"] = static_cast<Json::UInt64>(primaryCalls_.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < kWorkloadCount; ++i) {
+        Json::Value pool;
+        pool["pool"] = pools_[i] ? "separate" : "primary";
+        pool["calls"] = static_cast<Json::UInt64>(poolCalls_[i].load(std::memory_order_relaxed));
+        result["read_pools"][workloadName(static_cast<Workload>(i))] = pool;
+    }
+    result["fast_read_calls"] = static_cast<Json::UInt64>(fastCalls_.load(std::memory_order_relaxed));
+    return result;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "../app_config/workload.h"
+#include <drogon/orm/DbClient.h>
+#include <json/json.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+// Идентификаторы всех запросов к хранимым функциям
+enum class StatementId : size_t {
+    UniqueDates,
+    UniqueDatesPage,
+    MaintenanceDates,
+    MaintenanceDatesPage,
+    AllNodes,
+    Subnodes,
+    NodeTree,
+    NodeReport,
+    DailyReport,
+    PeriodReport,
+    PeriodReportCursor,
+    PeriodReportFetch,
+    MaintenanceReport,
+    MaintenanceReportPage,
+    RemainingServiceKm,
+    AddMaintenance,
+    IngestStagingCreate,
+    IngestStagingCopy,
+    IngestMerge,
+    Count
+};
+
+// Сервер, на котором выполняется запрос
+enum class DbRole {
+    Read,   // Отчеты и справочники: пул чтения класса нагрузки (реплика)
+    Write   // Изменения и чтения, которым нужна актуальность (основной сервер)
+};
+
+// Размер порции чтения курсора (совпадает с FETCH FORWARD в тексте запросов)
+constexpr size_t kCursorFetchRows = 256;
+
+// Реестр запросов: единственное место, где хранится текст SQL.
+// Текст каждого запроса неизменен, поэтому запросы с параметрами Drogon
+// готовит (PQprepare) один раз на соединение и дальше выполняет
+// подготовленный оператор; запросы без параметров идут простым протоколом.
+// Параметры привязываются с явными типами в SQL, отсутствующее значение
+// передается как настоящий NULL (std::nullopt / nullptr).
+// Для каждого запроса ведутся счетчики вызовов, ошибок и времени.
+// Запросы чтения идут в пул своего класса нагрузки (если задан), а
+// короткие запросы из IO-потоков — в быстрый клиент потока (если задан);
+// запись — в основной пул.
+class StatementRegistry {
+public:
+    using Pools = std::array<drogon::orm::DbClientPtr, kWorkloadCount>;
+
+    // pools — пулы чтения по классам нагрузки (nullptr — чтение через primary);
+    // fastReader — имя быстрого клиента Drogon для класса interactive (пусто — не используется)
+    explicit StatementRegistry(drogon::orm::DbClientPtr primary, Pools pools = {},
+                               std::string fastReader = {});
+
+    StatementRegistry(const StatementRegistry&) = delete;
+    StatementRegistry& operator=(const StatementRegistry&) = delete;
+
+    // Асинхронное выполнение запроса по идентификатору
+    template <typename OnResult, typename OnError, typename... Args>
+    void execAsync(StatementId id, OnResult&& onResult, OnError&& onError, Args&&... args) {
+        execAsyncOn(clientFor(id), id, std::forward<OnResult>(onResult),
+                    std::forward<OnError>(onError), std::forward<Args>(args)...);
+    }
+
+    // Выполнение запроса в указанном клиенте (например, в транзакции с курсором)
+    template <typename Client, typename OnResult, typename OnError, typename... Args>
+    void execAsyncOn(const std::shared_ptr<Client>& client, StatementId id,
+                     OnResult&& onResult, OnError&& onError, Args&&... args) {
+        Stats* stats = &stats_[index(id)];
+        stats->calls.fetch_add(1, std::memory_order_relaxed);
+        const auto start = Clock::now();
+
+        client->execSqlAsync(
+            sql(id),
+            [stats, start, onResult = std::forward<OnResult>(onResult)](
+                const drogon::orm::Result& result) mutable {
+                stats->record(Clock::now() - start);
+                onResult(result);
+            },
+            [stats, start, onError = std::forward<OnError>(onError)](
+                const drogon::orm::DrogonDbException& e) mutable {
+                stats->errors.fetch_add(1, std::memory_order_relaxed);
+                stats->record(Clock::now() - start);
+                onError(e);
+            },
+            std::forward<Args>(args)...
+        );
+    }
+
+    // Учет запроса, выполненного вне Drogon (libpq напрямую, например COPY)
+    void record(StatementId id, std::chrono::steady_clock::duration elapsed, bool failed) {
+        Stats& stats = stats_[index(id)];
+        stats.calls.fetch_add(1, std::memory_order_relaxed);
+        if (failed) stats.errors.fetch_add(1, std::memory_order_relaxed);
+        stats.record(elapsed);
+    }
+
+    // Пул для запроса (для транзакций и синхронных вызовов; без быстрых клиентов)
+    const drogon::orm::DbClientPtr& client(StatementId id) const {
+        const auto& pool = pools_[static_cast<size_t>(workload(id))];
+        return role(id) == DbRole::Read && pool ? pool : primary_;
+    }
+
+    // Текст, имя, класс нагрузки и сервер запроса
+    static const char* sql(StatementId id);
+    static const char* name(StatementId id);
+    static Workload workload(StatementId id);
+    static DbRole role(StatementId id);
+
+    // Счетчики по всем запросам (для /metrics)
+    Json::Value metrics() const;
+
+    // Вызовы по пулам: основной, чтения, быстрые клиенты (для /metrics)
+    Json::Value routingMetrics() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        std::atomic<uint64_t> calls{0};        // Вызовы
+        std::atomic<uint64_t> errors{0};       // Ошибки БД
+        std::atomic<uint64_t> completed{0};    // Завершенные вызовы
+        std::atomic<uint64_t> totalMicros{0};  // Суммарное время
+        std::atomic<uint64_t> maxMicros{0};    // Максимальное время
+
+        void record(Clock::duration elapsed);
+    };
+
+    static constexpr size_t index(StatementId id) { return static_cast<size_t>(id); }
+
+    // Клиент для асинхронного вызова: быстрый клиент IO-потока, пул класса или основной
+    drogon::orm::DbClientPtr clientFor(StatementId id);
+
+    drogon::orm::DbClientPtr primary_;  // Основной пул (запись)
+    Pools pools_;                       // Пулы чтения классов (могут быть пусты)
+    std::string fastReader_;            // Имя быстрого клиента чтения
+    std::array<Stats, static_cast<size_t>(StatementId::Count)> stats_;
+
+    // Вызовы по пулам
+    std::atomic<uint64_t> primaryCalls_{0};
+    std::array<std::atomic<uint64_t>, kWorkloadCount> poolCalls_{};
+    std::atomic<uint64_t> fastCalls_{0};
+};
@@ -1,13 +1,23 @@
 #include "controllers/car_controller/car_controller.h"
+#include "controllers/fleet_controller/fleet_controller.h"
+#include "crypto/key_manager.h"
+#include "crypto/wifi_credentials.h"
+#include "storage/record_store.h"
+#include "utilities/worker_pool.h"
 #include "utilities/utilities.h"
 #include "app_config/app_config.h"
+#include "app_config/app_settings.h"
+#include "app_config/config_reloader.h"
+#include "app_config/workload_gate.h"
 #include "sd_bus/sd_bus.h"
 #include <drogon/drogon.h>
 #include <drogon/orm/DbClient.h>
+#include <algorithm>
 #include <csignal>
 #include <cstdlib>
 #include <iostream>
 #include <sstream>
+#include <thread>
 #include <vector>
 #include "controllers/date_controller/date_controller.h"
 #include "controllers/node_controller/node_controller.h"
@@ -17,6 +27,13 @@
 #include "controllers/period_report_controller/period_report_controller.h"
 #include "controllers/maintenance_controller/maintenance_controller.h"
 #include "controllers/service_controller/service_controller.h"
+#include "controllers/metrics_controller/metrics_controller.h"
+#include "db/statement_registry.h"
+#include "cache/report_fetcher.h"
+#include "db/cursor_stream.h"
+#include "db/node_tree.h"
+#include "db/copy_ingest.h"
+#include "db/group_commit.h"
 
 using namespace drogon;
 using namespace drogon::orm;
@@ -53,6 +70,9 @@ int main() {
         }
     }
 
+    // Перезагрузка конфигурации без перезапуска (inotify, SIGHUP)
+    std::unique_ptr<ConfigReloader> reloader;
+
     try {
         // Загрузка конфигурации приложения
         configureApplication();
@@ -78,30 +98,178 @@ int main() {
         }
 
         // Формирование строки подключения
-        std::ostringstream connectionString;
-        connectionString << "host=" << dbHost
-                        << " port=" << dbPort
-                        << " dbname=" << dbName
-                        << " user=" << dbUser
-                        << " password=" << dbPassword;
-
-        // Инициализация БД
-        auto dbClient = DbClient::newPgClient(connectionString.str(), maxConnections);
-        
+        auto makeConnectionString = [&](const std::string& host, uint16_t port) {
+            std::ostringstream connectionString;
+            connectionString << "host=" << host
+                            << " port=" << port
+                            << " dbname=" << dbName
+                            << " user=" << dbUser
+                            << " password=" << dbPassword;
+            return connectionString.str();
+        };
+        const std::string connectionString = makeConnectionString(dbHost, dbPort);
+
+        // Классы нагрузки (секция workloads): собственные пулы чтения и
+        // таймауты запросов к БД; 0 — без таймаута
+        const auto settings = currentSettings();
+        const auto& workloads = settings->workloads;
+        auto timeoutSeconds = [&workloads](Workload workload) {
+            const auto timeout = workloads[static_cast<size_t>(workload)].timeout;
+            return timeout.count() > 0 ? timeout.count() / 1000.0 : -1.0;
+        };
+
+        // Бюджет соединений DB_MAX_CONNECTIONS на весь процесс: пулы чтения
+        // классов, быстрые клиенты (на каждый IO-поток), LISTEN дерева узлов и
+        // сессии COPY вычитаются, основной пул получает остаток
+        constexpr size_t kIngestSessions = 2;
+        constexpr size_t kListenConnections = 1;
+        size_t reservedConnections = settings->fastReadConnections * settings->threads +
+                                     kListenConnections + kIngestSessions;
+        for (const Workload workload : {Workload::Interactive, Workload::Report}) {
+            reservedConnections += workloads[static_cast<size_t>(workload)].connections;
+        }
+        if (reservedConnections >= maxConnections) {
+            LOG_FATAL << "DB_MAX_CONNECTIONS = " << maxConnections << " меньше необходимого: пулы чтения, "
+                      << "быстрые клиенты, LISTEN и COPY занимают " << reservedConnections
+                      << ", основному пулу нужно хотя бы одно";
+            return EXIT_FAILURE;
+        }
+        const size_t primaryConnections = maxConnections - reservedConnections;
+        LOG_INFO << "Соединений с БД: " << maxConnections << ", из них основной пул: " << primaryConnections;
+
+        // Инициализация БД: основной пул (запись и чтения, которым нужна актуальность)
+        // с таймаутом класса ingest
+        auto dbClient = DbClient::newPgClient(connectionString, primaryConnections);
+        dbClient->setTimeout(timeoutSeconds(Workload::Ingest));
+
+        // Пулы чтения классов interactive и report (при необходимости на
+        // реплике): отчеты не занимают соединения коротких запросов
+        const std::string readHost = settings->readHost.empty() ? dbHost : settings->readHost;
+        const uint16_t readPort = settings->readPort ? settings->readPort : dbPort;
+        const std::string readConnectionString = makeConnectionString(readHost, readPort);
+        StatementRegistry::Pools readPools;
+        for (const Workload workload : {Workload::Interactive, Workload::Report}) {
+            const size_t connections = workloads[static_cast<size_t>(workload)].connections;
+            auto pool = DbClient::newPgClient(readConnectionString, connections);
+            pool->setTimeout(timeoutSeconds(workload));
+            readPools[static_cast<size_t>(workload)] = std::move(pool);
+            LOG_INFO << "Пул чтения " << workloadName(workload) << ": " << readHost << ":" << readPort
+                     << ", соединений: " << connections;
+        }
+
+        // Быстрые клиенты чтения класса interactive: свои соединения у каждого IO-потока
+        std::string fastReader;
+        if (settings->fastReadConnections > 0) {
+            fastReader = "read_fast";
+            app().createDbClient("postgresql", readHost, readPort, dbName, dbUser, dbPassword,
+                                 settings->fastReadConnections, "", fastReader, true, "",
+                                 timeoutSeconds(Workload::Interactive), false);
+        }
+
+        // Реестр запросов к хранимым функциям (общий для контроллеров БД)
+        auto statements = std::make_shared<StatementRegistry>(dbClient, readPools, fastReader);
+        const size_t reportConnections = workloads[static_cast<size_t>(Workload::Report)].connections;
+
+        // Кэш тел ответов отчетов (64 МБ, изменяемые отчеты живут 60 с).
+        // Варианты gzip/brotli сжимаются один раз на отчет в отдельном пуле.
+        const size_t compressThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+        auto compressPool = std::make_shared<WorkerPool>(compressThreads, compressThreads * 16);
+        auto reportCache = std::make_shared<ResponseCache>(64 * 1024 * 1024);
+        auto reports = std::make_shared<ReportFetcher>(statements, reportCache, compressPool,
+                                                       std::chrono::seconds(60));
+
+        // Потоковые отчеты держат соединение БД на время ответа: не больше половины пула отчетов
+        auto streamer = std::make_shared<CursorStreamer>(statements, std::max<size_t>(1, reportConnections / 2));
+
+        // Дерево узлов в памяти (/nodes, проверка имен отчетов за период):
+        // загрузка при старте, обновление по NOTIFY, таймеру и неизвестному имени
+        auto nodeTree = std::make_shared<NodeTree>(statements);
+        try {
+            nodeTree->load();
+        } catch (const std::exception& e) {
+            LOG_WARN << "Дерево узлов не загружено при старте: " << e.what();
+        }
+        nodeTree->listen(connectionString);
+        app().getLoop()->runEvery(300.0, [nodeTree] { nodeTree->refresh(); });
+
+        // Групповая запись /add-maintenance (окно и предел — секция maintenance
+        // конфигурации); после записи отчеты по ТО в кэше сбрасываются
+        auto commits = std::make_shared<GroupCommit>(
+            statements, [reportCache] { reportCache->invalidate(kMaintenanceCacheTag); });
+
+        // Потоковая загрузка ТО (NDJSON -> COPY): отдельные соединения libpq,
+        // не больше двух загрузок одновременно, с таймаутом класса ingest
+        // на стороне сервера; после каждой порции отчеты по ТО в кэше сбрасываются
+        std::string ingestConnectionString = connectionString;
+        if (const auto timeout = workloads[static_cast<size_t>(Workload::Ingest)].timeout; timeout.count() > 0) {
+            ingestConnectionString += " options='-c statement_timeout=" + std::to_string(timeout.count()) + "'";
+        }
+        auto ingestPool = std::make_shared<WorkerPool>(kIngestSessions, kIngestSessions * 2);
+        auto ingest = std::make_shared<CopyIngest>(
+            statements, ingestPool, ingestConnectionString, kIngestSessions,
+            [reportCache] { reportCache->invalidate(kMaintenanceCacheTag); });
+
+        // Допуск запросов по классам нагрузки: при заполненной очереди
+        // класса — 503 с Retry-After
+        auto gate = std::make_shared<WorkloadGate>();
+        gate->install();
+
         // Регистрация контроллеров
-        auto registerController = [&dbClient](auto controller) {
+        auto registerController = [](auto controller) {
             app().registerController(controller);
             return controller;
         };
 
-        registerController(std::make_shared<DateController>(dbClient));
-        registerController(std::make_shared<NodeController>(dbClient));
-        registerController(std::make_shared<ReportController>(dbClient));
-        registerController(std::make_shared<MaintenanceReportController>(dbClient));
-        registerController(std::make_shared<DailyReportController>(dbClient));
-        registerController(std::make_shared<PeriodReportController>(dbClient));
-        registerController(std::make_shared<MaintenanceController>(dbClient));
-        registerController(std::make_shared<ServiceController>(dbClient));
+        // Однократный вывод ключа шифрования данных автомобилей
+        auto keys = std::make_shared<KeyManager>(
+            getenv("CAR_ENCRYPTION_KEY"),
+            getenv("CAR_ENCRYPTION_SALT"),
+            currentSettings()->pbkdf2Iterations
+        );
+
+        // Фоновая расшифровка учетных данных Wi-Fi (без запуска openssl)
+        auto wifi = std::make_shared<WifiCredentials>();
+
+        // Журнал записей парка автомобилей (ключ — VIN)
+        auto fleetStore = std::make_shared<RecordStore>("car_fleet.log");
+
+        // Пул для пакетного шифрования записей (вне IO-потоков)
+        const size_t poolThreads = std::max(1u, std::thread::hardware_concurrency());
+        auto fleetPool = std::make_shared<WorkerPool>(poolThreads, poolThreads * 16);
+
+        registerController(std::make_shared<CarController>(keys, wifi));
+        registerController(std::make_shared<FleetController>(keys, fleetStore, fleetPool));
+        registerController(std::make_shared<DateController>(statements));
+        registerController(std::make_shared<NodeController>(nodeTree));
+        registerController(std::make_shared<ReportController>(reports));
+        registerController(std::make_shared<MaintenanceReportController>(reports, statements));
+        registerController(std::make_shared<DailyReportController>(reports));
+        registerController(std::make_shared<PeriodReportController>(reports, streamer, nodeTree));
+        registerController(std::make_shared<MaintenanceController>(commits, ingest));
+        registerController(std::make_shared<ServiceController>(reports));
+        registerController(std::make_shared<MetricsController>(statements, reportCache, reports, streamer, nodeTree,
+                                                               commits, ingest, gate));
+
+        // Политика CORS применяется из снимка сама; ключ выводится заново
+        // только при смене числа итераций (старые записи читаются по заголовку,
+        // прежний ключ запоминается). PBKDF2 выполняется в отдельном потоке, а не
+        // в цикле событий; задача берет число итераций из текущего снимка,
+        // поэтому изменение, пришедшее во время вывода, не теряется.
+        auto keyPool = std::make_shared<WorkerPool>(1, 1);
+        reloader = std::make_unique<ConfigReloader>(kConfigFile,
+            [keys, keyPool](const AppSettings& prev, const AppSettings& next) {
+                if (prev.pbkdf2Iterations == next.pbkdf2Iterations) return;
+                keyPool->trySubmit([keys] {
+                    const int iterations = currentSettings()->pbkdf2Iterations;
+                    if (iterations == keys->iterations()) return;
+                    try {
+                        keys->rotate(iterations);
+                        LOG_INFO << "Ключ шифрования выведен заново: " << iterations << " итераций";
+                    } catch (const std::exception& e) {
+                        LOG_ERROR << "Ключ шифрования не выведен: " << e.what();
+                    }
+                });
+            });
 
         // Проверка подключения
         auto result = dbClient->execSqlSync("SELECT 1 AS connection_test;");
@@ -125,15 +293,14 @@ int main() {
     };
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    signal(SIGHUP, [](int) { ConfigReloader::requestReload(); });
 
     try {
-        // Получение параметров сервера из конфига
-        const auto& config = app().getCustomConfig();
-        const auto& serverConfig = config["server"];
-        
-        const std::string address = serverConfig.get("listen_address", "0.0.0.0").asString();
-        const uint16_t port = serverConfig.get("port", 8080).asUInt();
-        const unsigned threadNum = serverConfig.get("threads", std::thread::hardware_concurrency()).asUInt();
+        // Параметры сервера из снимка конфигурации (применяются только при старте)
+        const auto settings = currentSettings();
+        const std::string& address = settings->listenAddress;
+        const uint16_t port = settings->port;
+        const unsigned threadNum = settings->threads;
 
         LOG_INFO << "Запуск сервера на " << address << ":" << port;
         LOG_INFO << "Количество рабочих потоков: " << threadNum;
@@ -142,6 +309,8 @@ int main() {
             .setLogLevel(trantor::Logger::kWarn)
             .addListener(address, port)
             .setThreadNum(threadNum)
+            .setClientMaxBodySize(16 * 1024 * 1024) // Пакетный импорт /car/batch
+            .enableRequestStream() // Потоковое тело /add-maintenance/stream
             .run();
 
     } catch(const std::exception& e) {
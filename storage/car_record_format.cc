@@ -0,0 +1,208 @@
+#include "car_record_format.h"
+#include "../crypto/crypto_engine.h"
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace car_record {
+
+namespace {
+
+constexpr unsigned char kMagic[kMagicSize] = {'R', 'C', 'A', 'R'};
+
+// Смещения полей заголовка
+constexpr size_t kVersionOffset = kMagicSize;
+constexpr size_t kCipherOffset = kVersionOffset + 2;
+constexpr size_t kKdfOffset = kCipherOffset + 1;
+constexpr size_t kIterationsOffset = kKdfOffset + 1;
+constexpr size_t kNonceOffset = kIterationsOffset + 4;
+constexpr size_t kTagOffset = kHeaderSize + kPayloadSize;
+
+static_assert(kNonceSize == crypto_engine::kGcmNonceSize, "GCM nonce size mismatch");
+static_assert(kTagSize == crypto_engine::kGcmTagSize, "GCM tag size mismatch");
+
+// Запись/чтение little-endian целых
+void putU16(unsigned char* out, uint16_t value) {
+    out[0] = static_cast<unsigned char>(value);
+    out[1] = static_cast<unsigned char>(value >> 8);
+}
+
+void putU32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+uint16_t getU16(const unsigned char* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+uint32_t getU32(const unsigned char* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    return value;
+}
+
+// Последовательный писатель/читатель полей схемы
+struct FieldWriter {
+    unsigned char* pos;
+
+    void text(const char* src, size_t size) {
+        std::memcpy(pos, src, size);
+        pos[size - 1] = 0; // Строки всегда завершаются нулем
+        pos += size;
+    }
+    void i32(int32_t value) { putU32(pos, static_cast<uint32_t>(value)); pos += 4; }
+    void f32(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putU32(pos, bits);
+        pos += 4;
+    }
+    void byte(char value) { *pos++ = static_cast<unsigned char>(value); }
+};
+
+struct FieldReader {
+    const unsigned char* pos;
+
+    void text(char* dest, size_t size) {
+        std::memcpy(dest, pos, size);
+        dest[size - 1] = 0;
+        pos += size;
+    }
+    int32_t i32() { int32_t value = static_cast<int32_t>(getU32(pos)); pos += 4; return value; }
+    float f32() {
+        uint32_t bits = getU32(pos);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        pos += 4;
+        return value;
+    }
+    char byte() { return static_cast<char>(*pos++); }
+};
+
+} // namespace
+
+// Проверка сигнатуры нового формата
+bool hasMagic(const unsigned char* data, size_t size) {
+    return size >= kMagicSize && std::memcmp(data, kMagic, kMagicSize) == 0;
+}
+
+// Разбор и проверка заголовка
+Header parseHeader(const unsigned char* data, size_t size) {
+    if (!hasMagic(data, size)) {
+        throw std::runtime_error("Invalid record magic");
+    }
+    if (size != kRecordSize) {
+        throw std::runtime_error("Invalid file size");
+    }
+
+    Header header;
+    header.version = getU16(data + kVersionOffset);
+    header.cipher = data[kCipherOffset];
+    header.kdf = data[kKdfOffset];
+    header.iterations = getU32(data + kIterationsOffset);
+
+    if (header.version != kVersion) {
+        throw std::runtime_error("Unsupported record version");
+    }
+    if (header.cipher != kCipherAes256Gcm || header.kdf != kKdfPbkdf2Sha256) {
+        throw std::runtime_error("Unsupported record cipher or KDF");
+    }
+    if (header.iterations < kMinIterations || header.iterations > kMaxIterations) {
+        throw std::runtime_error("Invalid KDF parameters");
+    }
+    return header;
+}
+
+// Шифрование записи: заголовок аутентифицируется как AAD
+void seal(const CarDetails& details, const unsigned char* key, uint32_t iterations, Record& out) {
+    unsigned char* data = out.data();
+    std::memcpy(data, kMagic, kMagicSize);
+    putU16(data + kVersionOffset, kVersion);
+    data[kCipherOffset] = kCipherAes256Gcm;
+    data[kKdfOffset] = kKdfPbkdf2Sha256;
+    putU32(data + kIterationsOffset, iterations);
+    if (RAND_bytes(data + kNonceOffset, kNonceSize) != 1) {
+        throw std::runtime_error("Nonce generation failed");
+    }
+
+    unsigned char plain[kPayloadSize];
+    encodeFields(details, plain);
+    try {
+        crypto_engine::gcmSeal(key, data + kNonceOffset, data, kHeaderSize,
+                               plain, kPayloadSize, data + kHeaderSize, data + kTagOffset);
+    } catch (...) {
+        OPENSSL_cleanse(plain, sizeof(plain));
+        throw;
+    }
+    OPENSSL_cleanse(plain, sizeof(plain));
+}
+
+// Расшифровка с проверкой тега за один проход
+void open(const unsigned char* data, size_t size, const unsigned char* key, CarDetails& out) {
+    parseHeader(data, size);
+
+    unsigned char plain[kPayloadSize];
+    bool authentic = false;
+    try {
+        authentic = crypto_engine::gcmOpen(key, data + kNonceOffset, data, kHeaderSize,
+                                           data + kHeaderSize, kPayloadSize,
+                                           data + kTagOffset, plain);
+    } catch (...) {
+        OPENSSL_cleanse(plain, sizeof(plain));
+        throw;
+    }
+
+    // Тег проверяется при финализации: при несовпадении данные не используются
+    if (!authentic) {
+        OPENSSL_cleanse(plain, sizeof(plain));
+        throw std::runtime_error("Record authentication failed");
+    }
+
+    decodeFields(plain, out);
+    OPENSSL_cleanse(plain, sizeof(plain));
+}
+
+// Тег аутентификации записи
+const unsigned char* tag(const unsigned char* data) {
+    return data + kTagOffset;
+}
+
+// Явная сериализация полей в порядке схемы
+void encodeFields(const CarDetails& details, unsigned char* out) {
+    FieldWriter writer{out};
+    writer.text(details.wi_fi, sizeof(details.wi_fi));
+    writer.text(details.password, sizeof(details.password));
+    writer.text(details.vin, sizeof(details.vin));
+    writer.text(details.license_plate, sizeof(details.license_plate));
+    writer.text(details.brand, sizeof(details.brand));
+    writer.text(details.model, sizeof(details.model));
+    writer.i32(details.year);
+    writer.byte(details.transmission);
+    writer.text(details.body_type, sizeof(details.body_type));
+    writer.text(details.body_number, sizeof(details.body_number));
+    writer.f32(details.engine_volume);
+    writer.i32(details.engine_power);
+    writer.text(details.engine_type, sizeof(details.engine_type));
+    writer.text(details.color, sizeof(details.color));
+}
+
+void decodeFields(const unsigned char* in, CarDetails& details) {
+    FieldReader reader{in};
+    reader.text(details.wi_fi, sizeof(details.wi_fi));
+    reader.text(details.password, sizeof(details.password));
+    reader.text(details.vin, sizeof(details.vin));
+    reader.text(details.license_plate, sizeof(details.license_plate));
+    reader.text(details.brand, sizeof(details.brand));
+    reader.text(details.model, sizeof(details.model));
+    details.year = reader.i32();
+    details.transmission = reader.byte();
+    reader.text(details.body_type, sizeof(details.body_type));
+    reader.text(details.body_number, sizeof(details.body_number));
+    details.engine_volume = reader.f32();
+    details.engine_power = reader.i32();
+    reader.text(details.engine_type, sizeof(details.engine_type));
+    reader.text(details.color, sizeof(details.color));
+}
+
+} // namespace car_record
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../struct_data/car_struct.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Версионированный формат записи данных автомобиля (AES-256-GCM).
+//
+// Раскладка (все числа little-endian):
+//   magic      4 байта  "RCAR"
+//   version    2 байта  версия формата (1)
+//   cipher     1 байт   1 = AES-256-GCM
+//   kdf        1 байт   1 = PBKDF2-HMAC-SHA256
+//   iterations 4 байта  число итераций KDF, которым выведен ключ
+//   nonce     12 байт   случайный nonce GCM
+//   payload  195 байт   зашифрованные поля CarDetails (схема ниже)
+//   tag       16 байт   тег аутентификации GCM (заголовок — AAD)
+//
+// Поля CarDetails кодируются явно, в порядке объявления: строки —
+// фиксированной длины с нулевым заполнением, int32 и float (IEEE-754) —
+// little-endian. Формат не зависит от упаковки структуры в памяти.
+namespace car_record {
+
+constexpr uint16_t kVersion = 1;
+constexpr uint8_t kCipherAes256Gcm = 1;
+constexpr uint8_t kKdfPbkdf2Sha256 = 1;
+
+// Допустимое число итераций KDF (заголовок вне пределов — ошибка разбора;
+// те же пределы проверяются для pbkdf2_iterations в настройках)
+constexpr uint32_t kMinIterations = 10000;
+constexpr uint32_t kMaxIterations = 10000000;
+
+constexpr size_t kMagicSize = 4;
+constexpr size_t kNonceSize = 12;
+constexpr size_t kTagSize = 16;
+constexpr size_t kHeaderSize = kMagicSize + 2 + 1 + 1 + 4 + kNonceSize;
+constexpr size_t kPayloadSize = 195;
+constexpr size_t kRecordSize = kHeaderSize + kPayloadSize + kTagSize;
+
+using Record = std::array<unsigned char, kRecordSize>;
+
+// Заголовок записи
+struct Header {
+    uint16_t version = 0;
+    uint8_t cipher = 0;
+    uint8_t kdf = 0;
+    uint32_t iterations = 0;
+};
+
+// Проверка сигнатуры нового формата
+bool hasMagic(const unsigned char* data, size_t size);
+
+// Разбор и проверка заголовка (исключение при неподдерживаемой версии)
+Header parseHeader(const unsigned char* data, size_t size);
+
+// Шифрование записи в буфер вызывающего
+void seal(const CarDetails& details, const unsigned char* key, uint32_t iterations, Record& out);
+
+// Проверка тега и расшифровка за один проход в структуру вызывающего
+void open(const unsigned char* data, size_t size, const unsigned char* key, CarDetails& out);
+
+// Тег аутентификации записи (используется как версия содержимого)
+const unsigned char* tag(const unsigned char* data);
+
+// Явная сериализация полей CarDetails
+void encodeFields(const CarDetails& details, unsigned char* out);
+void decodeFields(const unsigned char* in, CarDetails& details);
+
+} // namespace car_record
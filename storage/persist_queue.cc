@@ -0,0 +1,111 @@
+#include "persist_queue.h"
+#include "../utilities/utilities.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Ошибка системного вызова с текстом errno
+[[noreturn]] void throwErrno(const std::string& what) {
+    throw std::runtime_error(what + ": " + strerror(errno));
+}
+}
+
+// Конструктор: запуск фонового потока записи
+PersistQueue::PersistQueue(std::string path) : path_(std::move(path)) {
+    thread_ = std::thread(&PersistQueue::run, this);
+}
+
+// Деструктор: дописывает ожидающее состояние и останавливает поток
+PersistQueue::~PersistQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+// Постановка записи в очередь с объединением
+void PersistQueue::submit(std::string data, std::function<void()> commit, Completion done) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Более новое состояние заменяет еще не записанное
+        pendingData_ = std::move(data);
+        pendingCommit_ = std::move(commit);
+        pendingDone_.push_back(std::move(done));
+        hasPending_ = true;
+    }
+    cv_.notify_one();
+}
+
+// Цикл фонового потока
+void PersistQueue::run() {
+    while (true) {
+        std::string data;
+        std::function<void()> commit;
+        std::vector<Completion> done;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return hasPending_ || stopping_; });
+            if (!hasPending_) return;
+            data = std::move(pendingData_);
+            commit = std::move(pendingCommit_);
+            done.swap(pendingDone_);
+            hasPending_ = false;
+        }
+
+        std::string error;
+        try {
+            writeAtomically(path_, data);
+            if (commit) commit();
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        for (auto& callback : done) {
+            if (callback) callback(error);
+        }
+    }
+}
+
+// Атомарная замена файла: временный файл, fsync, rename, fsync каталога
+void PersistQueue::writeAtomically(const std::string& path, const std::string& data) {
+    const std::string tmpPath = path + ".tmp";
+
+    {
+        FileDescriptorGuard fd(open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                                    S_IRUSR | S_IWUSR));
+        if (fd == -1) throwErrno("Temp file open failed");
+
+        // Запись всего буфера (с учетом частичных записей)
+        size_t offset = 0;
+        while (offset < data.size()) {
+            ssize_t written = write(fd, data.data() + offset, data.size() - offset);
+            if (written == -1) {
+                if (errno == EINTR) continue;
+                throwErrno("Data write failed");
+            }
+            offset += static_cast<size_t>(written);
+        }
+
+        if (fsync(fd) != 0) throwErrno("fsync failed");
+    }
+
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+        throwErrno("rename failed");
+    }
+
+    // Фиксация записи каталога, иначе rename может потеряться при сбое питания
+    fs::path directory = fs::absolute(path).parent_path();
+    FileDescriptorGuard dirFd(open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (dirFd == -1) throwErrno("Directory open failed");
+    if (fsync(dirFd) != 0) throwErrno("Directory fsync failed");
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Очередь фоновой записи файла с гарантией атомарности.
+// Запись выполняется в отдельном потоке: временный файл -> fsync ->
+// rename поверх целевого -> fsync каталога. Если несколько записей
+// поступили до начала обработки, на диск попадает только последняя,
+// а все ожидающие получают результат этой записи.
+class PersistQueue {
+public:
+    // Результат записи: пустая строка — успех, иначе текст ошибки
+    using Completion = std::function<void(const std::string& error)>;
+
+    explicit PersistQueue(std::string path);
+    ~PersistQueue();
+
+    PersistQueue(const PersistQueue&) = delete;
+    PersistQueue& operator=(const PersistQueue&) = delete;
+
+    // Постановка записи в очередь.
+    // commit вызывается после успешной записи, только для последней
+    // из объединенных записей; done — для каждой поставленной записи.
+    void submit(std::string data, std::function<void()> commit, Completion done);
+
+    // Синхронная атомарная запись (используется и фоновым потоком)
+    static void writeAtomically(const std::string& path, const std::string& data);
+
+private:
+    void run();
+
+    std::string path_;                 // Целевой файл
+    std::mutex mutex_;                 // Защита очереди
+    std::condition_variable cv_;       // Сигнал о новой записи
+    bool hasPending_ = false;          // Есть ожидающая запись
+    bool stopping_ = false;            // Флаг остановки потока
+    std::string pendingData_;          // Последнее состояние для записи
+    std::function<void()> pendingCommit_;   // Фиксация последнего состояния
+    std::vector<Completion> pendingDone_;   // Ожидающие завершения
+    std::thread thread_;               // Фоновый поток записи
+};
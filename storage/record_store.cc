@@ -0,0 +1,378 @@
+#include "record_store.h"
+#include "../utilities/utilities.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr unsigned char kMagic[4] = {'R', 'L', 'O', 'G'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kFileHeaderSize = 8;
+constexpr size_t kEntryHeaderSize = 4 + 2 + 4;   // crc + длина ключа + длина значения
+constexpr size_t kMinMapSize = 1 << 20;           // Минимальное отображение: 1 МБ
+constexpr size_t kMinCompactSize = 1 << 20;       // Журналы меньше 1 МБ не уплотняются
+
+[[noreturn]] void throwErrno(const std::string& what) {
+    throw std::runtime_error(what + ": " + strerror(errno));
+}
+
+// Отображение файла только для чтения размером не меньше required
+// (кратно странице); size — фактический размер отображения
+unsigned char* mapFile(int fd, size_t required, size_t& size) {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size = (std::max(required, kMinMapSize) + page - 1) / page * page;
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) throwErrno("Log mmap failed");
+    return static_cast<unsigned char*>(map);
+}
+
+void putU16(std::string& out, uint16_t value) {
+    out += static_cast<char>(value & 0xFF);
+    out += static_cast<char>(value >> 8);
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+uint16_t getU16(const unsigned char* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+uint32_t getU32(const unsigned char* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    return value;
+}
+
+// Сериализация записи журнала в конец буфера
+void appendEntry(std::string& out, const std::string& key, const std::string& value) {
+    if (key.empty() || key.size() > UINT16_MAX || value.size() > UINT32_MAX) {
+        throw std::runtime_error("Invalid record key or value size");
+    }
+    const size_t start = out.size();
+    putU32(out, 0); // место под CRC
+    putU16(out, static_cast<uint16_t>(key.size()));
+    putU32(out, static_cast<uint32_t>(value.size()));
+    out += key;
+    out += value;
+
+    uint32_t crc = crc32(0, reinterpret_cast<const Bytef*>(out.data() + start + 4),
+                         out.size() - start - 4);
+    for (int i = 0; i < 4; ++i) out[start + i] = static_cast<char>((crc >> (8 * i)) & 0xFF);
+}
+
+// Полная запись буфера по смещению
+void writeAll(int fd, const char* data, size_t size, off_t offset) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t written = pwrite(fd, data + done, size - done, offset + static_cast<off_t>(done));
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            throwErrno("Log write failed");
+        }
+        done += static_cast<size_t>(written);
+    }
+}
+
+// fsync каталога после rename
+void syncDirectory(const std::string& path) {
+    fs::path directory = fs::absolute(path).parent_path();
+    FileDescriptorGuard dirFd(::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (dirFd == -1 || fsync(dirFd) != 0) throwErrno("Directory fsync failed");
+}
+
+} // namespace
+
+// Конструктор: открытие журнала и восстановление индекса
+RecordStore::RecordStore(std::string path) : path_(std::move(path)) {
+    open();
+}
+
+RecordStore::~RecordStore() {
+    if (map_) munmap(map_, mapSize_);
+    if (fd_ != -1) close(fd_);
+}
+
+// Открытие (или создание) журнала
+void RecordStore::open() {
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd_ == -1) throwErrno("Log open failed");
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0) throwErrno("Log stat failed");
+    fileSize_ = static_cast<size_t>(st.st_size);
+
+    // Новый журнал: запись заголовка
+    if (fileSize_ < kFileHeaderSize) {
+        std::string header(reinterpret_cast<const char*>(kMagic), sizeof(kMagic));
+        putU32(header, kVersion);
+        if (ftruncate(fd_, 0) != 0) throwErrno("Log truncate failed");
+        writeAll(fd_, header.data(), header.size(), 0);
+        if (fdatasync(fd_) != 0) throwErrno("Log sync failed");
+        fileSize_ = header.size();
+    }
+
+    remap(fileSize_);
+    if (std::memcmp(map_, kMagic, sizeof(kMagic)) != 0 || getU32(map_ + 4) != kVersion) {
+        throw std::runtime_error("Unsupported record log format: " + path_);
+    }
+    recover();
+}
+
+// Перечитывание журнала: построение индекса и отсечение оборванного хвоста.
+// Отсекается только хвост, за которым нет ни одной целой записи (обрыв
+// последней записи при сбое); поврежденная запись в середине журнала —
+// ошибка открытия, последующие записи остаются в файле.
+void RecordStore::recover() {
+    size_t pos = kFileHeaderSize;
+    while (pos < fileSize_) {
+        const size_t size = validEntrySize(pos);
+        if (size == 0) {
+            for (size_t next = pos + 1; next + kEntryHeaderSize <= fileSize_; ++next) {
+                if (validEntrySize(next) != 0) {
+                    throw std::runtime_error("Corrupt record at offset " + std::to_string(pos) + " in " +
+                                             path_ + ": later records are kept, repair the log");
+                }
+            }
+            break;
+        }
+
+        const unsigned char* entry = map_ + pos;
+        std::string key(reinterpret_cast<const char*>(entry + kEntryHeaderSize), getU16(entry + 4));
+        auto [it, inserted] = index_.try_emplace(std::move(key), Location{pos, size});
+        if (!inserted) {
+            liveBytes_ -= it->second.size;
+            it->second = Location{pos, size};
+        }
+        liveBytes_ += size;
+        pos += size;
+    }
+
+    // Обрыв записи при сбое: хвост отбрасывается
+    if (pos < fileSize_) {
+        if (ftruncate(fd_, static_cast<off_t>(pos)) != 0) throwErrno("Log truncate failed");
+        if (fdatasync(fd_) != 0) throwErrno("Log sync failed");
+        fileSize_ = pos;
+    }
+}
+
+// Размер целой записи по смещению pos (0 — запись оборвана или повреждена)
+size_t RecordStore::validEntrySize(size_t pos) const {
+    if (pos + kEntryHeaderSize > fileSize_) return 0;
+    const unsigned char* entry = map_ + pos;
+    const size_t keySize = getU16(entry + 4);
+    const size_t size = kEntryHeaderSize + keySize + getU32(entry + 6);
+    if (keySize == 0 || size > fileSize_ - pos) return 0;
+    return crc32(0, entry + 4, static_cast<uInt>(size - 4)) == getU32(entry) ? size : 0;
+}
+
+// Расширение отображения до требуемого размера (под уникальной блокировкой)
+void RecordStore::remap(size_t required) {
+    if (map_ && required <= mapSize_) return;
+
+    size_t size = 0;
+    unsigned char* map = mapFile(fd_, std::max(required, mapSize_ * 2), size);
+    if (map_) munmap(map_, mapSize_);
+    map_ = map;
+    mapSize_ = size;
+}
+
+// Чтение значения по ключу
+bool RecordStore::get(const std::string& key, std::string& value) const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) return false;
+
+    const unsigned char* entry = map_ + it->second.offset;
+    const size_t keySize = getU16(entry + 4);
+    const size_t valueSize = getU32(entry + 6);
+    value.assign(reinterpret_cast<const char*>(entry + kEntryHeaderSize + keySize), valueSize);
+    return true;
+}
+
+bool RecordStore::contains(const std::string& key) const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex_);
+    return index_.count(key) != 0;
+}
+
+size_t RecordStore::size() const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex_);
+    return index_.size();
+}
+
+// Запись одного значения
+void RecordStore::put(const std::string& key, const std::string& value) {
+    putBatch({{key, value}});
+}
+
+// Запись только нового ключа (проверка и запись под одной блокировкой писателя)
+bool RecordStore::insert(const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (contains(key)) return false;
+
+    std::string buffer;
+    appendEntry(buffer, key, value);
+    appendLocked(buffer, {{key, 0}});
+
+    if (needsCompaction()) compactLocked();
+    return true;
+}
+
+// Запись пачки значений
+void RecordStore::putBatch(const std::vector<Entry>& entries) {
+    if (entries.empty()) return;
+
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    // Сборка всех записей в одном буфере
+    std::string buffer;
+    std::vector<std::pair<std::string, size_t>> placed; // ключ, смещение в буфере
+    placed.reserve(entries.size());
+    for (const auto& [key, value] : entries) {
+        placed.emplace_back(key, buffer.size());
+        appendEntry(buffer, key, value);
+    }
+
+    appendLocked(buffer, placed);
+
+    if (needsCompaction()) compactLocked();
+}
+
+// Запись пачки новых ключей (проверка и запись под одной блокировкой писателя)
+std::vector<bool> RecordStore::insertBatch(const std::vector<Entry>& entries) {
+    std::vector<bool> inserted(entries.size(), false);
+    if (entries.empty()) return inserted;
+
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    std::string buffer;
+    std::vector<std::pair<std::string, size_t>> placed;
+    placed.reserve(entries.size());
+    {
+        std::shared_lock<std::shared_mutex> readLock(mapMutex_);
+        std::unordered_set<std::string> seen;
+        seen.reserve(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const auto& [key, value] = entries[i];
+            if (index_.count(key) != 0 || !seen.insert(key).second) continue;
+            placed.emplace_back(key, buffer.size());
+            appendEntry(buffer, key, value);
+            inserted[i] = true;
+        }
+    }
+
+    if (!placed.empty()) {
+        appendLocked(buffer, placed);
+        if (needsCompaction()) compactLocked();
+    }
+    return inserted;
+}
+
+// Дозапись буфера и обновление индекса (под writeMutex_)
+void RecordStore::appendLocked(const std::string& buffer,
+                               const std::vector<std::pair<std::string, size_t>>& placed) {
+    // Каталог после уплотнения не синхронизирован: без этого дозапись
+    // в новый файл может пропасть после сбоя
+    if (dirSyncPending_) {
+        syncDirectory(path_);
+        dirSyncPending_ = false;
+    }
+
+    // Запись и синхронизация выполняются без блокировки читателей
+    writeAll(fd_, buffer.data(), buffer.size(), static_cast<off_t>(fileSize_));
+    if (fdatasync(fd_) != 0) throwErrno("Log sync failed");
+
+    std::unique_lock<std::shared_mutex> lock(mapMutex_);
+    remap(fileSize_ + buffer.size());
+    for (size_t i = 0; i < placed.size(); ++i) {
+        const size_t begin = placed[i].second;
+        const size_t end = i + 1 < placed.size() ? placed[i + 1].second : buffer.size();
+        Location location{fileSize_ + begin, end - begin};
+
+        auto [it, inserted] = index_.try_emplace(placed[i].first, location);
+        if (!inserted) {
+            liveBytes_ -= it->second.size;
+            it->second = location;
+        }
+        liveBytes_ += location.size;
+    }
+    fileSize_ += buffer.size();
+}
+
+// Мертвых записей больше, чем живых
+bool RecordStore::needsCompaction() const {
+    const size_t dataSize = fileSize_ - kFileHeaderSize;
+    return fileSize_ >= kMinCompactSize && dataSize - liveBytes_ > liveBytes_;
+}
+
+// Принудительное уплотнение
+void RecordStore::compact() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    compactLocked();
+}
+
+// Перезапись живых записей в новый журнал и атомарная замена (под writeMutex_)
+void RecordStore::compactLocked() {
+    const std::string tmpPath = path_ + ".compact";
+
+    // Читатели не мешают: отображение меняет только писатель
+    std::string buffer(reinterpret_cast<const char*>(map_), kFileHeaderSize);
+    buffer.reserve(kFileHeaderSize + liveBytes_);
+    std::unordered_map<std::string, Location> index;
+    index.reserve(index_.size());
+    for (const auto& [key, location] : index_) {
+        index.emplace(key, Location{buffer.size(), location.size});
+        buffer.append(reinterpret_cast<const char*>(map_ + location.offset), location.size);
+    }
+
+    // Новый файл отображается до rename: после rename замена уже не может
+    // завершиться ошибкой, а при ошибке до него журнал остается прежним
+    int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd == -1) throwErrno("Compaction open failed");
+    unsigned char* map = nullptr;
+    size_t mapSize = 0;
+    try {
+        writeAll(fd, buffer.data(), buffer.size(), 0);
+        if (fsync(fd) != 0) throwErrno("Compaction sync failed");
+        map = mapFile(fd, buffer.size(), mapSize);
+        if (rename(tmpPath.c_str(), path_.c_str()) != 0) throwErrno("Compaction rename failed");
+    } catch (...) {
+        if (map) munmap(map, mapSize);
+        close(fd);
+        unlink(tmpPath.c_str());
+        throw;
+    }
+
+    // После rename старый файл недоступен по пути: дозапись идет только в новый
+    std::unique_lock<std::shared_mutex> lock(mapMutex_);
+    munmap(map_, mapSize_);
+    map_ = map;
+    mapSize_ = mapSize;
+    close(fd_);
+    fd_ = fd;
+    fileSize_ = buffer.size();
+    liveBytes_ = fileSize_ - kFileHeaderSize;
+    index_.swap(index);
+
+    // Новая запись каталога должна быть на диске до подтверждения
+    // следующей дозаписи; при ошибке fsync повторяется перед ней
+    dirSyncPending_ = true;
+    try {
+        syncDirectory(path_);
+        dirSyncPending_ = false;
+    } catch (const std::exception&) {
+        // Повтор перед следующей дозаписью
+    }
+}
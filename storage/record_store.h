@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Хранилище записей по ключу: журнал только на дозапись, отображенный
+// в память (mmap), и индекс ключ -> смещение в оперативной памяти.
+//
+// Формат файла: заголовок "RLOG" + версия (u32), далее записи
+//   crc32 (u32) | длина ключа (u16) | длина значения (u32) | ключ | значение
+// CRC покрывает все поля записи после себя; числа little-endian.
+// Обновление дописывает новую запись, старая становится «мертвой».
+// При открытии журнал перечитывается; оборванная при сбое последняя
+// запись отрезается, поврежденная запись в середине журнала — ошибка
+// открытия (std::runtime_error со смещением записи). Когда мертвых
+// данных становится больше, чем живых, журнал уплотняется.
+class RecordStore {
+public:
+    using Entry = std::pair<std::string, std::string>; // ключ, значение
+
+    explicit RecordStore(std::string path);
+    ~RecordStore();
+
+    RecordStore(const RecordStore&) = delete;
+    RecordStore& operator=(const RecordStore&) = delete;
+
+    // Чтение значения по ключу (O(1)); false — ключ не найден
+    bool get(const std::string& key, std::string& value) const;
+    bool contains(const std::string& key) const;
+
+    // Запись одного значения (дозапись + fdatasync)
+    void put(const std::string& key, const std::string& value);
+
+    // Запись только нового ключа; false — ключ уже существует
+    bool insert(const std::string& key, const std::string& value);
+
+    // Запись пачки значений одним write и одним fdatasync
+    void putBatch(const std::vector<Entry>& entries);
+
+    // Запись пачки только новых ключей одним write и одним fdatasync.
+    // Результат по каждому элементу: false — ключ уже существует
+    // (в журнале или ранее в этой же пачке), элемент не записан.
+    std::vector<bool> insertBatch(const std::vector<Entry>& entries);
+
+    // Число живых ключей
+    size_t size() const;
+
+    // Принудительное уплотнение журнала
+    void compact();
+
+private:
+    void open();
+    void recover();
+    size_t validEntrySize(size_t pos) const;
+    void remap(size_t required);
+    void appendLocked(const std::string& buffer, const std::vector<std::pair<std::string, size_t>>& placed);
+    void compactLocked();
+    bool needsCompaction() const;
+
+    std::string path_;                 // Путь к журналу
+    int fd_ = -1;                      // Дескриптор журнала
+    unsigned char* map_ = nullptr;     // Отображение журнала
+    size_t mapSize_ = 0;               // Размер отображения
+    size_t fileSize_ = 0;              // Размер данных журнала
+    size_t liveBytes_ = 0;             // Объем живых записей
+    bool dirSyncPending_ = false;      // fsync каталога после уплотнения не выполнен
+
+    // Смещение и размер последней записи ключа
+    struct Location {
+        size_t offset;
+        size_t size;
+    };
+    std::unordered_map<std::string, Location> index_;
+
+    std::mutex writeMutex_;                 // Сериализация писателей
+    mutable std::shared_mutex mapMutex_;    // Защита индекса и отображения
+};
@@ -0,0 +1,154 @@
+#include "car_json.h"
+#include <trantor/utils/Logger.h>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+
+// Безопасное копирование строки в поле фиксированной длины
+void copyCarField(const std::string& src, char* dest, size_t max) {
+    if(src.length() >= max) throw std::runtime_error("Field length exceeded");
+    snprintf(dest, max, "%s", src.c_str());
+}
+
+// Парсинг JSON в структуру CarDetails
+void parseCarJson(const Json::Value& json, CarDetails& details) {
+    // Лямбда для обработки полей JSON
+    auto copyField = [&](const char* field, char* dest, size_t max) {
+        if(!json.isMember(field)) throw std::runtime_error("Missing field: " + std::string(field));
+        copyCarField(json[field].asString(), dest, max);
+    };
+
+    // Обработка каждого поля с валидацией
+    copyField("vin", details.vin, 18);
+    validateVIN(details.vin); // Валидация VIN
+    
+    copyField("license_plate", details.license_plate, 10);
+    copyField("brand", details.brand, 20);
+    copyField("model", details.model, 20);
+    copyField("body_type", details.body_type, 20);
+    copyField("body_number", details.body_number, 10);
+    copyField("engine_type", details.engine_type, 4);
+    copyField("color", details.color, 20);
+    
+    // Обработка числовых полей
+    details.year = json.get("year", 0).asInt();
+    if(details.year < 1886 || details.year > 2024) {
+        throw std::runtime_error("Invalid production year");
+    }
+    
+    // Обработка поля трансмиссии
+    std::string transmission = json.get("transmission", "").asString();
+    details.transmission = !transmission.empty() ? transmission[0] : ' ';
+    
+    // Проверка объема двигателя
+    details.engine_volume = json.get("engine_volume", 0.0f).asFloat();
+    if(details.engine_volume < 0) {
+        throw std::runtime_error("Invalid engine volume");
+    }
+    
+    // Проверка мощности двигателя
+    details.engine_power = json.get("engine_power", 0).asInt();
+    if(details.engine_power < 0) {
+        throw std::runtime_error("Invalid engine power");
+    }
+}
+
+// Применение разрешенных изменений из PATCH-запроса
+void applyCarPatch(const Json::Value& json, CarDetails& details) {
+    for (const auto& key : json.getMemberNames()) {
+        const std::string field = key;
+        const Json::Value& value = json[key];
+        
+        if(field == "license_plate") {
+            std::string plateValue = value.asString();
+            if(plateValue.length() > 9) throw std::runtime_error("License plate too long");
+            std::fill(std::begin(details.license_plate), 
+                    std::end(details.license_plate), 0);
+            std::copy(plateValue.begin(), plateValue.end(), details.license_plate);
+        }
+        else if(field == "transmission") {
+            std::string transmissionValue = value.asString();
+            if(transmissionValue.empty()) continue;
+            details.transmission = transmissionValue[0];
+        }
+        else if(field == "body_type") {
+            std::string bodyTypeValue = value.asString();
+            if(bodyTypeValue.length() > 19) throw std::runtime_error("Body type too long");
+            std::fill(std::begin(details.body_type), 
+                    std::end(details.body_type), 0);
+            std::copy(bodyTypeValue.begin(), bodyTypeValue.end(), details.body_type);
+        }
+        else if(field == "engine_volume") {
+            float engineVolumeValue = value.asFloat();
+            if(engineVolumeValue <= 0) throw std::runtime_error("Invalid engine volume");
+            details.engine_volume = engineVolumeValue;
+        }
+        else if(field == "engine_power") {
+            int enginePowerValue = value.asInt();
+            if(enginePowerValue < 0) throw std::runtime_error("Invalid engine power");
+            details.engine_power = enginePowerValue;
+        }
+        else if(field == "engine_type") {
+            std::string engineTypeValue = value.asString();
+            if(engineTypeValue.length() > 3) throw std::runtime_error("Engine type too long");
+            std::fill(std::begin(details.engine_type), 
+                    std::end(details.engine_type), 0);
+            std::copy(engineTypeValue.begin(), engineTypeValue.end(), details.engine_type);
+        }
+        else if(field == "color") {
+            std::string colorValue = value.asString();
+            if(colorValue.length() > 19) throw std::runtime_error("Color name too long");
+            std::fill(std::begin(details.color), 
+                    std::end(details.color), 0);
+            std::copy(colorValue.begin(), colorValue.end(), details.color);
+        }
+        else {
+            LOG_WARN << "Attempt to modify restricted field: " << field;
+            throw std::runtime_error("Modifying field " + field + " is prohibited");
+        }
+    }
+}
+
+// Валидация VIN номера
+// 17 символов: цифры и латинские заглавные буквы, кроме I, O, Q.
+// Проверка посимвольная: std::regex заметно дороже при пакетном импорте
+void validateVIN(const char* vin) {
+    size_t length = 0;
+    for (; vin[length] != '\0'; ++length) {
+        const char c = vin[length];
+        const bool digit = c >= '0' && c <= '9';
+        const bool letter = c >= 'A' && c <= 'Z' && c != 'I' && c != 'O' && c != 'Q';
+        if (length >= 17 || (!digit && !letter)) {
+            throw std::runtime_error("Invalid VIN format");
+        }
+    }
+    if (length != 17) {
+        throw std::runtime_error("Invalid VIN format");
+    }
+}
+
+// Конвертация структуры в JSON
+void carToJson(const CarDetails& details, Json::Value& json) {
+    json["wi_fi"] = details.wi_fi;
+    json["password"] = "[hidden]";  // Маскировка пароля
+    json["vin"] = details.vin;
+    json["license_plate"] = details.license_plate;
+    json["brand"] = details.brand;
+    json["model"] = details.model;
+    json["year"] = details.year;
+    json["transmission"] = std::string(1, details.transmission);
+    json["body_type"] = details.body_type;
+    json["body_number"] = details.body_number;
+    json["engine_volume"] = details.engine_volume;
+    json["engine_power"] = details.engine_power;
+    json["engine_type"] = details.engine_type;
+    json["color"] = details.color;
+}
+
+// Компактная сериализация JSON в UTF-8
+std::string writeCompactJson(const Json::Value& json) {
+    Json::StreamWriterBuilder builder;
+    builder["emitUTF8"] = true;      // Использовать UTF-8
+    builder["indentation"] = "";     // Без отступов
+    return Json::writeString(builder, json);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "car_struct.h"
+#include <json/json.h>
+#include <string>
+
+// Преобразования CarDetails <-> JSON, общие для контроллеров автомобилей
+
+// Заполнение структуры из JSON запроса создания (без учетных данных Wi-Fi)
+void parseCarJson(const Json::Value& json, CarDetails& details);
+
+// Применение разрешенных изменений из PATCH-запроса
+void applyCarPatch(const Json::Value& json, CarDetails& details);
+
+// Конвертация структуры в JSON (пароль маскируется)
+void carToJson(const CarDetails& details, Json::Value& json);
+
+// Компактная сериализация JSON в UTF-8
+std::string writeCompactJson(const Json::Value& json);
+
+// Валидация VIN номера
+void validateVIN(const char* vin);
+
+// Безопасное копирование строки в поле фиксированной длины
+void copyCarField(const std::string& src, char* dest, size_t max);
@@ -0,0 +1,74 @@
+#include <drogon/drogon_test.h>
+#include "../controllers/car_controller/car_controller.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Рабочий каталог теста (контроллер работает с car_detail.bin в текущем каталоге)
+class ScopedDirectory {
+public:
+    ScopedDirectory() : previous_(fs::current_path()) {
+        path_ = fs::temp_directory_path() / ("radar_car_test_" + std::to_string(getpid()));
+        fs::remove_all(path_);
+        fs::create_directories(path_);
+        fs::current_path(path_);
+    }
+    ~ScopedDirectory() {
+        fs::current_path(previous_);
+        fs::remove_all(path_);
+    }
+
+private:
+    fs::path previous_;
+    fs::path path_;
+};
+
+void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Загрузка файла контроллером; после разрушения контроллера фоновая запись завершена
+void loadController() {
+    auto keys = std::make_shared<KeyManager>("test-secret", "test-salt", 10000);
+    auto wifi = std::make_shared<WifiCredentials>("/nonexistent");
+    auto controller = std::make_shared<CarController>(keys, wifi);
+    controller.reset();
+}
+}
+
+// Поврежденный файл старого формата (IV + CBC + SHA-256 + CRC32) не перезаписывается
+DROGON_TEST(CorruptLegacyCarFileIsNotMigrated)
+{
+    ScopedDirectory directory;
+    std::string corrupt(16 + 32 + 32 + 4, '\0');
+    for (size_t i = 0; i < corrupt.size(); ++i) corrupt[i] = static_cast<char>(i * 37 + 11);
+    writeFile("car_detail.bin", corrupt);
+
+    loadController();
+
+    CHECK(readFile("car_detail.bin") == corrupt);
+}
+
+// Пустой (обрезанный) файл тоже остается как есть
+DROGON_TEST(EmptyLegacyCarFileIsNotMigrated)
+{
+    ScopedDirectory directory;
+    writeFile("car_detail.bin", "");
+
+    loadController();
+
+    CHECK(fs::exists("car_detail.bin"));
+    CHECK(readFile("car_detail.bin").empty());
+}
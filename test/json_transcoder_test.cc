@@ -0,0 +1,346 @@
+#include <drogon/drogon_test.h>
+#include "../utilities/json_transcoder.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+// Разбор CBOR / MessagePack обратно в канонический текст: целые — десятичные,
+// float32/float64 — с префиксом f32:/f64:, строки — в кавычках без экранирования
+class Decoder {
+public:
+    Decoder(const std::string& data, BinaryFormat format) : data_(data), format_(format) {}
+
+    std::string value() {
+        return format_ == BinaryFormat::Cbor ? cbor() : msgpack();
+    }
+
+    bool done() const { return pos_ == data_.size(); }
+
+private:
+    uint8_t byte() {
+        if (pos_ >= data_.size()) throw std::runtime_error("unexpected end");
+        return static_cast<uint8_t>(data_[pos_++]);
+    }
+
+    uint64_t be(int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) value = (value << 8) | byte();
+        return value;
+    }
+
+    std::string text(uint64_t size) {
+        if (data_.size() - pos_ < size) throw std::runtime_error("short string");
+        std::string out = "\"" + data_.substr(pos_, size) + "\"";
+        pos_ += size;
+        return out;
+    }
+
+    std::string container(uint64_t size, bool isMap) {
+        std::string out = isMap ? "{" : "[";
+        for (uint64_t i = 0; i < size; ++i) {
+            if (i) out += ',';
+            out += value();
+            if (isMap) out += ":" + value();
+        }
+        return out + (isMap ? "}" : "]");
+    }
+
+    static std::string float32(uint32_t bits) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "f32:%.9g", value);
+        return buffer;
+    }
+
+    static std::string float64(uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        char buffer[40];
+        std::snprintf(buffer, sizeof(buffer), "f64:%.17g", value);
+        return buffer;
+    }
+
+    uint64_t cborArgument(uint8_t info) {
+        if (info < 24) return info;
+        if (info == 24) return be(1);
+        if (info == 25) return be(2);
+        if (info == 26) return be(4);
+        if (info == 27) return be(8);
+        throw std::runtime_error("bad CBOR argument");
+    }
+
+    std::string cbor() {
+        const uint8_t head = byte();
+        const uint8_t major = head >> 5;
+        const uint8_t info = head & 0x1F;
+        switch (major) {
+        case 0: return std::to_string(cborArgument(info));
+        case 1: return std::to_string(-1 - static_cast<int64_t>(cborArgument(info)));
+        case 3: return text(cborArgument(info));
+        case 4: return container(cborArgument(info), false);
+        case 5: return container(cborArgument(info), true);
+        case 7:
+            if (head == 0xf4) return "false";
+            if (head == 0xf5) return "true";
+            if (head == 0xf6) return "null";
+            if (head == 0xfa) return float32(static_cast<uint32_t>(be(4)));
+            if (head == 0xfb) return float64(be(8));
+            break;
+        }
+        throw std::runtime_error("unexpected CBOR item");
+    }
+
+    std::string msgpack() {
+        const uint8_t head = byte();
+        if (head < 0x80) return std::to_string(head);
+        if (head >= 0xe0) return std::to_string(static_cast<int8_t>(head));
+        if ((head & 0xF0) == 0x80) return container(head & 0x0F, true);
+        if ((head & 0xF0) == 0x90) return container(head & 0x0F, false);
+        if ((head & 0xE0) == 0xa0) return text(head & 0x1F);
+        switch (head) {
+        case 0xc0: return "null";
+        case 0xc2: return "false";
+        case 0xc3: return "true";
+        case 0xca: return float32(static_cast<uint32_t>(be(4)));
+        case 0xcb: return float64(be(8));
+        case 0xcc: return std::to_string(be(1));
+        case 0xcd: return std::to_string(be(2));
+        case 0xce: return std::to_string(be(4));
+        case 0xcf: return std::to_string(be(8));
+        case 0xd0: return std::to_string(static_cast<int8_t>(be(1)));
+        case 0xd1: return std::to_string(static_cast<int16_t>(be(2)));
+        case 0xd2: return std::to_string(static_cast<int32_t>(be(4)));
+        case 0xd3: return std::to_string(static_cast<int64_t>(be(8)));
+        case 0xd9: return text(be(1));
+        case 0xda: return text(be(2));
+        case 0xdb: return text(be(4));
+        case 0xdc: return container(be(2), false);
+        case 0xdd: return container(be(4), false);
+        case 0xde: return container(be(2), true);
+        case 0xdf: return container(be(4), true);
+        }
+        throw std::runtime_error("unexpected MessagePack item");
+    }
+
+    const std::string& data_;
+    BinaryFormat format_;
+    size_t pos_ = 0;
+};
+
+std::string encode(const std::string& json, BinaryFormat format) {
+    std::string out;
+    transcodeJson(json, format, out);
+    return out;
+}
+
+// Перекодирование и обратный разбор (весь буфер должен быть прочитан)
+std::string roundTrip(const std::string& json, BinaryFormat format) {
+    const std::string encoded = encode(json, format);
+    Decoder decoder(encoded, format);
+    std::string decoded = decoder.value();
+    if (!decoder.done()) throw std::runtime_error("trailing bytes");
+    return decoded;
+}
+
+// Первые байты представления (заголовок)
+std::string head(const std::string& json, BinaryFormat format, size_t size) {
+    return encode(json, format).substr(0, size);
+}
+
+std::string bytes(std::initializer_list<unsigned> values) {
+    std::string out;
+    for (unsigned value : values) out += static_cast<char>(value);
+    return out;
+}
+
+std::string zeros(size_t count) {
+    std::string json = "[";
+    for (size_t i = 0; i < count; ++i) json += i ? ",0" : "0";
+    return json + "]";
+}
+
+std::string keys(size_t count) {
+    std::string json = "{";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) json += ',';
+        json += "\"" + std::to_string(i) + "\":0";
+    }
+    return json + "}";
+}
+
+bool rejected(const std::string& json) {
+    for (const auto format : {BinaryFormat::Cbor, BinaryFormat::MsgPack}) {
+        try {
+            encode(json, format);
+            return false;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    return true;
+}
+
+constexpr BinaryFormat kCbor = BinaryFormat::Cbor;
+constexpr BinaryFormat kMsgPack = BinaryFormat::MsgPack;
+}
+
+// Заголовки массивов на границах коротких форм
+DROGON_TEST(TranscoderArrayHeaderBoundaries)
+{
+    CHECK(head(zeros(15), kMsgPack, 1) == bytes({0x9f}));
+    CHECK(head(zeros(16), kMsgPack, 3) == bytes({0xdc, 0x00, 0x10}));
+    CHECK(head(zeros(65535), kMsgPack, 3) == bytes({0xdc, 0xff, 0xff}));
+    CHECK(head(zeros(65536), kMsgPack, 5) == bytes({0xdd, 0x00, 0x01, 0x00, 0x00}));
+
+    CHECK(head(zeros(23), kCbor, 1) == bytes({0x97}));
+    CHECK(head(zeros(24), kCbor, 2) == bytes({0x98, 0x18}));
+    CHECK(head(zeros(65535), kCbor, 3) == bytes({0x99, 0xff, 0xff}));
+    CHECK(head(zeros(65536), kCbor, 5) == bytes({0x9a, 0x00, 0x01, 0x00, 0x00}));
+
+    for (const size_t count : {15, 16, 23, 24, 65535, 65536}) {
+        const std::string json = zeros(count);
+        std::string expected = json;
+        CHECK(roundTrip(json, kMsgPack) == expected);
+        CHECK(roundTrip(json, kCbor) == expected);
+    }
+}
+
+// Заголовки объектов на границах коротких форм
+DROGON_TEST(TranscoderMapHeaderBoundaries)
+{
+    CHECK(head(keys(15), kMsgPack, 1) == bytes({0x8f}));
+    CHECK(head(keys(16), kMsgPack, 3) == bytes({0xde, 0x00, 0x10}));
+    CHECK(head(keys(65535), kMsgPack, 3) == bytes({0xde, 0xff, 0xff}));
+    CHECK(head(keys(65536), kMsgPack, 5) == bytes({0xdf, 0x00, 0x01, 0x00, 0x00}));
+
+    CHECK(head(keys(23), kCbor, 1) == bytes({0xb7}));
+    CHECK(head(keys(24), kCbor, 2) == bytes({0xb8, 0x18}));
+    CHECK(head(keys(65535), kCbor, 3) == bytes({0xb9, 0xff, 0xff}));
+    CHECK(head(keys(65536), kCbor, 5) == bytes({0xba, 0x00, 0x01, 0x00, 0x00}));
+
+    for (const size_t count : {15, 16, 23, 24, 65535, 65536}) {
+        const std::string json = keys(count);
+        CHECK(roundTrip(json, kMsgPack) == json);
+        CHECK(roundTrip(json, kCbor) == json);
+    }
+}
+
+// Вложенные контейнеры считаются по отдельности
+DROGON_TEST(TranscoderNestedContainers)
+{
+    const std::string json = "{\"a\":[1,[2,3],{}],\"b\":{\"c\":[]},\"d\":\"x\"}";
+    CHECK(roundTrip(json, kMsgPack) == json);
+    CHECK(roundTrip(json, kCbor) == json);
+    CHECK(roundTrip(" [ true , false , null ] ", kCbor) == "[true,false,null]");
+}
+
+// Отрицательные целые: минимальная ширина на каждой границе
+DROGON_TEST(TranscoderNegativeIntegers)
+{
+    struct Case {
+        const char* json;
+        unsigned msgpack;  // Первый байт MessagePack
+        unsigned cbor;     // Первый байт CBOR
+    };
+    const Case cases[] = {
+        {"-1", 0xff, 0x20},
+        {"-24", 0xe8, 0x37},
+        {"-25", 0xe7, 0x38},
+        {"-32", 0xe0, 0x38},
+        {"-33", 0xd0, 0x38},
+        {"-128", 0xd0, 0x38},
+        {"-129", 0xd1, 0x38},
+        {"-256", 0xd1, 0x38},
+        {"-257", 0xd1, 0x39},
+        {"-32768", 0xd1, 0x39},
+        {"-32769", 0xd2, 0x39},
+        {"-65536", 0xd2, 0x39},
+        {"-65537", 0xd2, 0x3a},
+        {"-2147483648", 0xd2, 0x3a},
+        {"-2147483649", 0xd3, 0x3a},
+        {"-4294967296", 0xd3, 0x3a},
+        {"-4294967297", 0xd3, 0x3b},
+        {"-9223372036854775808", 0xd3, 0x3b},
+    };
+    for (const auto& item : cases) {
+        CHECK(head(item.json, kMsgPack, 1) == bytes({item.msgpack}));
+        CHECK(head(item.json, kCbor, 1) == bytes({item.cbor}));
+        CHECK(roundTrip(item.json, kMsgPack) == item.json);
+        CHECK(roundTrip(item.json, kCbor) == item.json);
+    }
+}
+
+// "-0" — целый ноль; "-0.0" сохраняет знак
+DROGON_TEST(TranscoderNegativeZero)
+{
+    CHECK(encode("-0", kMsgPack) == bytes({0x00}));
+    CHECK(encode("-0", kCbor) == bytes({0x00}));
+    CHECK(encode("-0.0", kMsgPack) == bytes({0xca, 0x80, 0x00, 0x00, 0x00}));
+    CHECK(encode("-0.0", kCbor) == bytes({0xfa, 0x80, 0x00, 0x00, 0x00}));
+    CHECK(roundTrip("-0e0", kCbor) == "f32:-0");
+}
+
+// Целые за пределами 64 бит передаются числом с плавающей точкой
+DROGON_TEST(TranscoderIntegersBeyond64Bits)
+{
+    CHECK(head("18446744073709551615", kMsgPack, 1) == bytes({0xcf}));
+    CHECK(head("18446744073709551615", kCbor, 1) == bytes({0x1b}));
+    CHECK(roundTrip("18446744073709551615", kCbor) == "18446744073709551615");
+
+    CHECK(roundTrip("18446744073709551616", kMsgPack) == "f32:1.84467441e+19");
+    CHECK(roundTrip("-9223372036854775809", kCbor) == "f32:-9.22337204e+18");
+    CHECK(roundTrip("123456789012345678901234567890", kCbor) == "f64:1.2345678901234568e+29");
+    CHECK(roundTrip("1" + std::string(80, '0'), kMsgPack) == "f64:1e+80");
+}
+
+// Суррогатные пары раскрываются в 4-байтовый UTF-8; непарные отклоняются
+DROGON_TEST(TranscoderSurrogatePairs)
+{
+    CHECK(roundTrip("\"\\ud83d\\ude00\"", kCbor) == "\"\xF0\x9F\x98\x80\"");
+    CHECK(roundTrip("\"a\\uD834\\uDD1Eb\"", kMsgPack) == "\"a\xF0\x9D\x84\x9E" "b\"");
+    CHECK(roundTrip("\"\\u00e9\\u20ac\"", kCbor) == "\"\xC3\xA9\xE2\x82\xAC\"");
+
+    CHECK(rejected("\"\\ud83d\""));
+    CHECK(rejected("\"\\ud83dx\""));
+    CHECK(rejected("\"\\ud83d\\u0041\""));
+    CHECK(rejected("\"\\ude00\""));
+    CHECK(rejected("\"\\ud83d\\ud83d\""));
+}
+
+// float32, если он представляет значение точно, иначе float64
+DROGON_TEST(TranscoderFloatWidth)
+{
+    CHECK(head("0.5", kMsgPack, 1) == bytes({0xca}));
+    CHECK(head("0.5", kCbor, 1) == bytes({0xfa}));
+    CHECK(head("0.1", kMsgPack, 1) == bytes({0xcb}));
+    CHECK(head("0.1", kCbor, 1) == bytes({0xfb}));
+
+    CHECK(roundTrip("16777216.0", kCbor) == "f32:16777216");
+    CHECK(roundTrip("16777217.0", kCbor) == "f64:16777217");
+    CHECK(roundTrip("3.4028234663852886e38", kMsgPack) == "f32:3.40282347e+38");
+    CHECK(head("1e39", kMsgPack, 1) == bytes({0xcb}));
+    CHECK(head("1e39", kCbor, 1) == bytes({0xfb}));
+    CHECK(roundTrip("1.5e-45", kCbor) == "f64:1.5000000000000001e-45");
+    CHECK(roundTrip("-2.25", kMsgPack) == "f32:-2.25");
+    CHECK(roundTrip("1E2", kCbor) == "f32:100");
+}
+
+// Числа вне грамматики JSON отклоняются в обоих форматах
+DROGON_TEST(TranscoderRejectsMalformedNumbers)
+{
+    for (const char* json : {"01", "-01", "1.", ".5", "+1", "-", "1e", "1e+", "1E-", "--1", "1.2.3",
+                             "1-2", "1e2e3", "0x10", "1..2", "-.5", "Infinity", "-Infinity", "NaN",
+                             "[1,]", "[01]", "{\"a\":1.}"}) {
+        CHECK(rejected(json));
+    }
+    CHECK(rejected("1" + std::string(80, '0') + "e"));
+    CHECK(rejected("1" + std::string(80, '0') + "x"));
+
+    CHECK(!rejected("0"));
+    CHECK(!rejected("-0.0e-0"));
+    CHECK(!rejected("10E+2"));
+}
@@ -0,0 +1,125 @@
+#include <drogon/drogon_test.h>
+#include "../storage/record_store.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Журнал во временном каталоге (удаляется после теста)
+class ScopedLog {
+public:
+    ScopedLog() {
+        directory_ = fs::temp_directory_path() / ("radar_store_test_" + std::to_string(getpid()));
+        fs::remove_all(directory_);
+        fs::create_directories(directory_);
+        path_ = (directory_ / "records.log").string();
+    }
+    ~ScopedLog() { fs::remove_all(directory_); }
+
+    const std::string& path() const { return path_; }
+
+private:
+    fs::path directory_;
+    std::string path_;
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// Три записи; смещение значения второй записи в файле
+size_t writeThreeRecords(const std::string& path) {
+    RecordStore store(path);
+    store.put("VIN0000000000001", "first");
+    store.put("VIN0000000000002", "second");
+    store.put("VIN0000000000003", "third");
+    const std::string data = readFile(path);
+    return data.find("second");
+}
+}
+
+// Поврежденная запись в середине: журнал не открывается и не обрезается
+DROGON_TEST(RecordStoreRejectsCorruptMiddleRecord)
+{
+    ScopedLog log;
+    const size_t offset = writeThreeRecords(log.path());
+    REQUIRE(offset != std::string::npos);
+
+    std::string data = readFile(log.path());
+    data[offset] ^= 0x01;
+    writeFile(log.path(), data);
+
+    bool rejected = false;
+    try {
+        RecordStore store(log.path());
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    CHECK(rejected);
+    CHECK(readFile(log.path()) == data);
+}
+
+// Оборванная последняя запись отрезается, предыдущие сохраняются
+DROGON_TEST(RecordStoreTrimsTornTail)
+{
+    ScopedLog log;
+    writeThreeRecords(log.path());
+    const std::string complete = readFile(log.path());
+    writeFile(log.path(), complete + std::string("\x12\x34\x56\x78\x10\x00\x05", 7));
+
+    RecordStore store(log.path());
+    std::string value;
+    CHECK(store.size() == 3);
+    CHECK(store.get("VIN0000000000003", value));
+    CHECK(value == "third");
+    CHECK(readFile(log.path()) == complete);
+}
+
+// Последняя запись с неверной контрольной суммой (частично записанные данные)
+DROGON_TEST(RecordStoreTrimsCorruptLastRecord)
+{
+    ScopedLog log;
+    writeThreeRecords(log.path());
+    std::string data = readFile(log.path());
+    data[data.size() - 1] ^= 0x01;
+    writeFile(log.path(), data);
+
+    RecordStore store(log.path());
+    std::string value;
+    CHECK(store.size() == 2);
+    CHECK(!store.get("VIN0000000000003", value));
+    CHECK(store.get("VIN0000000000002", value));
+    CHECK(value == "second");
+}
+
+// После уплотнения дозапись идет в файл, доступный по пути журнала
+DROGON_TEST(RecordStoreAppendsAfterCompaction)
+{
+    ScopedLog log;
+    {
+        RecordStore store(log.path());
+        store.put("VIN0000000000001", "old");
+        store.put("VIN0000000000001", "new");
+        store.compact();
+        store.put("VIN0000000000002", "after");
+    }
+
+    RecordStore reopened(log.path());
+    std::string value;
+    CHECK(reopened.size() == 2);
+    CHECK(reopened.get("VIN0000000000001", value));
+    CHECK(value == "new");
+    CHECK(reopened.get("VIN0000000000002", value));
+    CHECK(value == "after");
+}
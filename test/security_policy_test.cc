@@ -0,0 +1,73 @@
+#include <drogon/drogon_test.h>
+#include "../app_config/security_policy.h"
+#include <string>
+#include <vector>
+
+namespace {
+bool allowed(const std::vector<std::string>& patterns, const std::string& origin) {
+    SecurityPolicy policy(patterns);
+    return policy.allowOrigin(origin);
+}
+}
+
+// "*" разрешает любой непустой источник
+DROGON_TEST(SecurityPolicyAllowsAnyOrigin)
+{
+    CHECK(allowed({"*"}, "https://example.com"));
+    CHECK(allowed({"*"}, "null"));
+    CHECK(!allowed({"*"}, ""));
+}
+
+// Звездочка в начале: совпадает только суффикс
+DROGON_TEST(SecurityPolicyLeadingStar)
+{
+    CHECK(allowed({"*.example.com"}, "https://api.example.com"));
+    CHECK(allowed({"*.example.com"}, "https://a.b.example.com"));
+    CHECK(!allowed({"*.example.com"}, "https://example.com"));
+    CHECK(!allowed({"*.example.com"}, "https://api.example.com.evil.org"));
+}
+
+// Звездочка в конце: совпадает только префикс (в том числе вся строка)
+DROGON_TEST(SecurityPolicyTrailingStar)
+{
+    CHECK(allowed({"https://app*"}, "https://app"));
+    CHECK(allowed({"https://app*"}, "https://app.example.com:8443"));
+    CHECK(!allowed({"https://app*"}, "http://app.example.com"));
+}
+
+// Префикс и суффикс без звездочки по краям
+DROGON_TEST(SecurityPolicyPrefixAndSuffix)
+{
+    CHECK(allowed({"https://*.example.com"}, "https://api.example.com"));
+    CHECK(!allowed({"https://*.example.com"}, "http://api.example.com"));
+    CHECK(!allowed({"https://*.example.com"}, "https://api.example.com:8080"));
+    CHECK(!allowed({"https://*.example.com"}, "https://.example.co"));
+}
+
+// Префикс и суффикс не могут пересекаться в одном символе
+DROGON_TEST(SecurityPolicyOverlappingParts)
+{
+    CHECK(!allowed({"a*a"}, "a"));
+    CHECK(allowed({"a*a"}, "aa"));
+    CHECK(allowed({"a*a"}, "aba"));
+    CHECK(!allowed({"a*a"}, "ab"));
+    CHECK(!allowed({"*ab*ab*"}, "xabx"));
+    CHECK(allowed({"*ab*ab*"}, "abab"));
+    CHECK(!allowed({"ab*ba"}, "aba"));
+}
+
+// Средние части ищутся по порядку
+DROGON_TEST(SecurityPolicyMiddleParts)
+{
+    CHECK(allowed({"https://*.corp.*.com"}, "https://a.corp.b.com"));
+    CHECK(!allowed({"https://*.corp.*.com"}, "https://a.b.com"));
+    CHECK(!allowed({"https://*.b.*.a.com"}, "https://x.a.y.b.com"));
+}
+
+// Шаблоны и источники сравниваются без учета регистра
+DROGON_TEST(SecurityPolicyIgnoresCase)
+{
+    CHECK(allowed({"https://*.Example.COM"}, "HTTPS://API.example.com"));
+    CHECK(allowed({"https://App.Example.com"}, "https://app.EXAMPLE.com"));
+    CHECK(!allowed({"https://*.example.com"}, "https://api.example.org"));
+}
@@ -0,0 +1,45 @@
+#include <drogon/drogon_test.h>
+#include "../utilities/utilities.h"
+#include <string>
+
+namespace {
+const std::string kETag = "\"0123abcd\"";
+}
+
+// Пустой заголовок и пустые элементы списка не совпадают ни с чем
+DROGON_TEST(ETagMatchesEmptyTokens)
+{
+    CHECK(!etagMatches("", kETag));
+    CHECK(!etagMatches(",", kETag));
+    CHECK(!etagMatches(" , ,", kETag));
+    CHECK(etagMatches(",\"0123abcd\"", kETag));
+    CHECK(etagMatches("\"a\",,\"0123abcd\"", kETag));
+    CHECK(etagMatches("\"0123abcd\",", kETag));
+}
+
+// Слабый тег сравнивается без префикса W/
+DROGON_TEST(ETagMatchesWeakTag)
+{
+    CHECK(etagMatches("W/\"0123abcd\"", kETag));
+    CHECK(etagMatches(" W/\"0123abcd\" ", kETag));
+    CHECK(!etagMatches("W/\"other\"", kETag));
+    CHECK(!etagMatches("W/", kETag));
+}
+
+// "*" совпадает с любым представлением
+DROGON_TEST(ETagMatchesAny)
+{
+    CHECK(etagMatches("*", kETag));
+    CHECK(etagMatches(" * ", kETag));
+    CHECK(etagMatches("\"a\", *", kETag));
+}
+
+// Список из нескольких тегов (с пробелами и табуляциями)
+DROGON_TEST(ETagMatchesTagList)
+{
+    CHECK(etagMatches("\"a\", \"b\", \"0123abcd\"", kETag));
+    CHECK(etagMatches("\"a\",\t\"0123abcd\"\t", kETag));
+    CHECK(!etagMatches("\"a\", \"b\"", kETag));
+    CHECK(!etagMatches("\"0123abcd", kETag));
+    CHECK(!etagMatches("0123abcd", kETag));
+}
@@ -0,0 +1,78 @@
+#include "file_watcher.h"
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+// Конструктор: подписка на события каталога и запуск потока
+FileWatcher::FileWatcher(const std::string& path, std::function<void()> onChange)
+    : onChange_(std::move(onChange)) {
+    fs::path filePath = fs::absolute(path);
+    directory_ = filePath.parent_path().string();
+    filename_ = filePath.filename().string();
+
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ == -1) {
+        throw std::runtime_error(std::string("inotify init failed: ") + strerror(errno));
+    }
+
+    // Закрытие после записи, замена через rename и удаление
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+    if (inotify_add_watch(inotifyFd_, directory_.c_str(), mask) == -1) {
+        close(inotifyFd_);
+        throw std::runtime_error(std::string("inotify watch failed: ") + strerror(errno));
+    }
+
+    stopFd_ = eventfd(0, EFD_CLOEXEC);
+    if (stopFd_ == -1) {
+        close(inotifyFd_);
+        throw std::runtime_error(std::string("eventfd failed: ") + strerror(errno));
+    }
+
+    thread_ = std::thread(&FileWatcher::run, this);
+}
+
+// Деструктор: сигнал остановки и ожидание потока
+FileWatcher::~FileWatcher() {
+    uint64_t one = 1;
+    if (write(stopFd_, &one, sizeof(one)) != sizeof(one)) {
+        // Поток все равно завершится при закрытии дескрипторов ниже
+    }
+    if (thread_.joinable()) thread_.join();
+    close(stopFd_);
+    close(inotifyFd_);
+}
+
+// Цикл ожидания событий inotify
+void FileWatcher::run() {
+    alignas(struct inotify_event) char buffer[4096];
+    pollfd fds[2] = {{inotifyFd_, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+
+    while (true) {
+        if (poll(fds, 2, -1) == -1) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents & POLLIN) return;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        // Разбор пачки событий: колбэк вызывается один раз на пачку
+        bool changed = false;
+        ssize_t len;
+        while ((len = read(inotifyFd_, buffer, sizeof(buffer))) > 0) {
+            for (char* ptr = buffer; ptr < buffer + len;) {
+                auto* event = reinterpret_cast<struct inotify_event*>(ptr);
+                if (event->len > 0 && filename_ == event->name) changed = true;
+                ptr += sizeof(struct inotify_event) + event->len;
+            }
+        }
+
+        if (changed && onChange_) onChange_();
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <thread>
+
+// Наблюдение за изменениями файла через inotify.
+// Отслеживается каталог файла, поэтому замена файла через rename
+// и его удаление тоже обнаруживаются. Колбэк вызывается из
+// отдельного потока наблюдателя.
+class FileWatcher {
+public:
+    FileWatcher(const std::string& path, std::function<void()> onChange);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+private:
+    void run();
+
+    std::string directory_;           // Наблюдаемый каталог
+    std::string filename_;            // Имя отслеживаемого файла
+    std::function<void()> onChange_;  // Обработчик изменения
+    int inotifyFd_ = -1;              // Дескриптор inotify
+    int stopFd_ = -1;                 // eventfd для остановки потока
+    std::thread thread_;              // Поток наблюдателя
+};
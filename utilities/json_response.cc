@@ -0,0 +1,121 @@
+#include "json_response.h"
+#include "utilities.h"
+#include <drogon/drogon.h>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace drogon;
+
+namespace {
+// Общие заголовки JSON-ответа
+HttpResponsePtr newJsonResponse() {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setContentTypeCodeAndCustomString(
+        CT_APPLICATION_JSON,
+        "application/json; charset=utf-8"
+    );
+    return resp;
+}
+
+// MIME-тип двоичного формата
+const char* binaryContentType(BinaryFormat format) {
+    return format == BinaryFormat::Cbor ? "application/cbor" : "application/msgpack";
+}
+
+// Суффикс ETag двоичного формата
+const char* binaryETagSuffix(BinaryFormat format) {
+    return format == BinaryFormat::Cbor ? "-cbor" : "-msgpack";
+}
+}
+
+// Текст значения столбца
+std::string rawJson(const orm::Field& field) {
+    if (field.isNull()) return "null";
+    return std::string(field.c_str(), field.length());
+}
+
+// Ответ из готового текста
+HttpResponsePtr newRawJsonResponse(std::string&& body) {
+    auto resp = newJsonResponse();
+    resp->setBody(std::move(body));
+    return resp;
+}
+
+// Ответ из значения столбца: байты libpq копируются в тело один раз
+HttpResponsePtr newRawJsonResponse(const orm::Field& field) {
+    auto resp = newJsonResponse();
+    if (field.isNull()) {
+        resp->setBody("null");
+    } else {
+        resp->setBody(field.c_str(), field.length());
+    }
+    return resp;
+}
+
+// Разбор Accept: "application/cbor;q=0.9, application/json;q=0.5, */*;q=0.1"
+std::optional<BinaryFormat> negotiateBinaryFormat(std::string_view accept) {
+    double cborQ = 0, msgpackQ = 0, jsonQ = 0;
+
+    while (!accept.empty()) {
+        const size_t comma = accept.find(',');
+        std::string_view item = accept.substr(0, comma);
+        accept = comma == std::string_view::npos ? std::string_view() : accept.substr(comma + 1);
+
+        double q = 1.0;
+        const size_t semicolon = item.find(';');
+        if (semicolon != std::string_view::npos) {
+            std::string_view params = item.substr(semicolon + 1);
+            const size_t qPos = params.find("q=");
+            if (qPos != std::string_view::npos) {
+                q = std::strtod(std::string(params.substr(qPos + 2)).c_str(), nullptr);
+            }
+            item = item.substr(0, semicolon);
+        }
+        item = trimView(item);
+
+        if (equalsIgnoreCase(item, "application/cbor")) {
+            cborQ = std::max(cborQ, q);
+        } else if (equalsIgnoreCase(item, "application/msgpack") ||
+                   equalsIgnoreCase(item, "application/x-msgpack") ||
+                   equalsIgnoreCase(item, "application/vnd.msgpack")) {
+            msgpackQ = std::max(msgpackQ, q);
+        } else if (equalsIgnoreCase(item, "application/json") ||
+                   equalsIgnoreCase(item, "application/*") || item == "*/*") {
+            jsonQ = std::max(jsonQ, q);
+        }
+    }
+
+    if (cborQ > jsonQ && cborQ >= msgpackQ) return BinaryFormat::Cbor;
+    if (msgpackQ > jsonQ) return BinaryFormat::MsgPack;
+    return std::nullopt;
+}
+
+// Ответ в согласованном формате
+HttpResponsePtr newNegotiatedResponse(std::string&& json, std::optional<BinaryFormat> format) {
+    HttpResponsePtr resp;
+    if (format) {
+        try {
+            std::string body;
+            transcodeJson(json, *format, body);
+            resp = HttpResponse::newHttpResponse();
+            resp->setContentTypeCodeAndCustomString(CT_CUSTOM, binaryContentType(*format));
+            resp->setBody(std::move(body));
+        } catch (const std::invalid_argument& e) {
+            // Текст от БД не разобран: отдается как есть в JSON
+            LOG_ERROR << "Ошибка перекодирования ответа: " << e.what();
+        }
+    }
+    if (!resp) resp = newRawJsonResponse(std::move(json));
+    resp->addHeader("Vary", "Accept");
+    return resp;
+}
+
+// ETag представления
+std::string representationETag(const std::string& etag, std::optional<BinaryFormat> format) {
+    if (!format || etag.size() < 2 || etag.back() != '"') return etag;
+    std::string tagged = etag.substr(0, etag.size() - 1);
+    tagged += binaryETagSuffix(*format);
+    tagged += '"';
+    return tagged;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <drogon/HttpResponse.h>
+#include <drogon/orm/Field.h>
+#include "json_transcoder.h"
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Ответы с JSON, который уже сформирован PostgreSQL (функции отчетов
+// возвращают json/jsonb). Текст значения передается в тело ответа как
+// есть: без разбора в Json::Value и повторной сериализации.
+
+// Текст значения столбца (NULL — JSON null)
+std::string rawJson(const drogon::orm::Field& field);
+
+// Тело из готового JSON-текста (строка перемещается в ответ)
+drogon::HttpResponsePtr newRawJsonResponse(std::string&& body);
+
+// Тело из текстового значения столбца результата (одно копирование байтов).
+// NULL передается как JSON null.
+drogon::HttpResponsePtr newRawJsonResponse(const drogon::orm::Field& field);
+
+// Согласование формата по Accept: CBOR (application/cbor) или MessagePack
+// (application/msgpack, application/x-msgpack); nullopt — JSON (по умолчанию,
+// в том числе при равных весах)
+std::optional<BinaryFormat> negotiateBinaryFormat(std::string_view accept);
+
+// Ответ из готового JSON-текста в согласованном формате. Двоичный формат
+// пишется напрямую из текста, без Json::Value. Добавляется Vary: Accept.
+drogon::HttpResponsePtr newNegotiatedResponse(std::string&& json,
+                                              std::optional<BinaryFormat> format);
+
+// ETag представления: у двоичных форматов к тегу JSON добавляется суффикс
+std::string representationETag(const std::string& etag, std::optional<BinaryFormat> format);
@@ -0,0 +1,422 @@
+#include "json_transcoder.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Предел вложенности (защита стека от враждебного ввода)
+constexpr int kMaxDepth = 512;
+
+// Запись заголовков и скаляров в выбранном формате
+class Writer {
+public:
+    Writer(BinaryFormat format, std::string& out) : format_(format), out_(out) {}
+
+    void array(uint64_t size) {
+        if (format_ == BinaryFormat::Cbor) {
+            cborHead(4, size);
+        } else if (size < 16) {
+            put(0x90 | size);
+        } else if (size <= 0xFFFF) {
+            put(0xdc); be(size, 2);
+        } else {
+            put(0xdd); be(size, 4);
+        }
+    }
+
+    void map(uint64_t size) {
+        if (format_ == BinaryFormat::Cbor) {
+            cborHead(5, size);
+        } else if (size < 16) {
+            put(0x80 | size);
+        } else if (size <= 0xFFFF) {
+            put(0xde); be(size, 2);
+        } else {
+            put(0xdf); be(size, 4);
+        }
+    }
+
+    void string(const char* data, size_t size) {
+        if (format_ == BinaryFormat::Cbor) {
+            cborHead(3, size);
+        } else if (size < 32) {
+            put(0xa0 | size);
+        } else if (size <= 0xFF) {
+            put(0xd9); be(size, 1);
+        } else if (size <= 0xFFFF) {
+            put(0xda); be(size, 2);
+        } else {
+            put(0xdb); be(size, 4);
+        }
+        out_.append(data, size);
+    }
+
+    void uinteger(uint64_t value) {
+        if (format_ == BinaryFormat::Cbor) {
+            cborHead(0, value);
+        } else if (value < 128) {
+            put(value);
+        } else if (value <= 0xFF) {
+            put(0xcc); be(value, 1);
+        } else if (value <= 0xFFFF) {
+            put(0xcd); be(value, 2);
+        } else if (value <= 0xFFFFFFFF) {
+            put(0xce); be(value, 4);
+        } else {
+            put(0xcf); be(value, 8);
+        }
+    }
+
+    // Отрицательное целое
+    void negative(int64_t value) {
+        if (format_ == BinaryFormat::Cbor) {
+            cborHead(1, static_cast<uint64_t>(-(value + 1)));
+        } else if (value >= -32) {
+            put(0xe0 | (value + 32));
+        } else if (value >= INT8_MIN) {
+            put(0xd0); be(static_cast<uint8_t>(value), 1);
+        } else if (value >= INT16_MIN) {
+            put(0xd1); be(static_cast<uint16_t>(value), 2);
+        } else if (value >= INT32_MIN) {
+            put(0xd2); be(static_cast<uint32_t>(value), 4);
+        } else {
+            put(0xd3); be(static_cast<uint64_t>(value), 8);
+        }
+    }
+
+    void number(double value) {
+        const float narrow = static_cast<float>(value);
+        if (std::isfinite(value) && static_cast<double>(narrow) == value) {
+            uint32_t bits;
+            std::memcpy(&bits, &narrow, sizeof(bits));
+            put(format_ == BinaryFormat::Cbor ? 0xfa : 0xca);
+            be(bits, 4);
+        } else {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            put(format_ == BinaryFormat::Cbor ? 0xfb : 0xcb);
+            be(bits, 8);
+        }
+    }
+
+    void boolean(bool value) {
+        if (format_ == BinaryFormat::Cbor) {
+            put(value ? 0xf5 : 0xf4);
+        } else {
+            put(value ? 0xc3 : 0xc2);
+        }
+    }
+
+    void null() { put(format_ == BinaryFormat::Cbor ? 0xf6 : 0xc0); }
+
+private:
+    void put(uint64_t byte) { out_ += static_cast<char>(byte & 0xFF); }
+
+    // Целое в сетевом порядке байт
+    void be(uint64_t value, int bytes) {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            put(value >> shift);
+        }
+    }
+
+    // Заголовок CBOR: старший тип и аргумент минимальной длины
+    void cborHead(uint64_t major, uint64_t value) {
+        const uint64_t type = major << 5;
+        if (value < 24) {
+            put(type | value);
+        } else if (value <= 0xFF) {
+            put(type | 24); be(value, 1);
+        } else if (value <= 0xFFFF) {
+            put(type | 25); be(value, 2);
+        } else if (value <= 0xFFFFFFFF) {
+            put(type | 26); be(value, 4);
+        } else {
+            put(type | 27); be(value, 8);
+        }
+    }
+
+    BinaryFormat format_;
+    std::string& out_;
+};
+
+// Разбор JSON-текста. В режиме подсчета (writer == nullptr) сохраняет
+// число элементов каждого контейнера в порядке открытия; в режиме
+// записи использует эти числа для заголовков.
+class Transcoder {
+public:
+    Transcoder(std::string_view json, std::vector<uint64_t>& counts, Writer* writer)
+        : p_(json.data()), end_(json.data() + json.size()), counts_(counts), writer_(writer) {}
+
+    void run() {
+        value(0);
+        skipSpace();
+        if (p_ != end_) fail("лишние данные после значения");
+    }
+
+private:
+    [[noreturn]] static void fail(const char* what) {
+        throw std::invalid_argument(std::string("Некорректный JSON: ") + what);
+    }
+
+    void skipSpace() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (p_ != end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail("ожидается разделитель");
+    }
+
+    void value(int depth) {
+        if (depth > kMaxDepth) fail("слишком глубокая вложенность");
+        skipSpace();
+        if (p_ == end_) fail("неожиданный конец");
+
+        switch (*p_) {
+        case '[': array(depth); break;
+        case '{': object(depth); break;
+        case '"': string(); break;
+        case 't': literal("true", 4); if (writer_) writer_->boolean(true); break;
+        case 'f': literal("false", 5); if (writer_) writer_->boolean(false); break;
+        case 'n': literal("null", 4); if (writer_) writer_->null(); break;
+        default: number(); break;
+        }
+    }
+
+    void array(int depth) {
+        ++p_;
+        const size_t count = openContainer();
+        if (consume(']')) return;
+        do {
+            value(depth + 1);
+            if (!writer_) ++counts_[count];
+        } while (consume(','));
+        expect(']');
+    }
+
+    void object(int depth) {
+        ++p_;
+        const size_t count = openContainer(true);
+        if (consume('}')) return;
+        do {
+            skipSpace();
+            if (p_ == end_ || *p_ != '"') fail("ожидается ключ");
+            string();
+            expect(':');
+            value(depth + 1);
+            if (!writer_) ++counts_[count];
+        } while (consume(','));
+        expect('}');
+    }
+
+    // Индекс счетчика нового контейнера (подсчет) или запись его заголовка.
+    // Индекс, а не указатель: вложенные контейнеры расширяют вектор.
+    size_t openContainer(bool isMap = false) {
+        if (!writer_) {
+            counts_.push_back(0);
+            return counts_.size() - 1;
+        }
+        if (next_ >= counts_.size()) fail("несогласованный подсчет");
+        const uint64_t size = counts_[next_++];
+        if (isMap) {
+            writer_->map(size);
+        } else {
+            writer_->array(size);
+        }
+        return 0;
+    }
+
+    void literal(const char* text, size_t size) {
+        if (static_cast<size_t>(end_ - p_) < size || std::memcmp(p_, text, size) != 0) {
+            fail("неизвестный литерал");
+        }
+        p_ += size;
+    }
+
+    void string() {
+        const char* start = ++p_;
+        // Быстрый путь: строка без экранирования передается как есть
+        while (p_ != end_ && *p_ != '"' && *p_ != '\\') {
+            if (static_cast<unsigned char>(*p_) < 0x20) fail("управляющий символ в строке");
+            ++p_;
+        }
+        if (p_ == end_) fail("незакрытая строка");
+        if (*p_ == '"') {
+            if (writer_) writer_->string(start, p_ - start);
+            ++p_;
+            return;
+        }
+
+        scratch_.assign(start, p_ - start);
+        while (p_ != end_ && *p_ != '"') {
+            if (*p_ != '\\') {
+                if (static_cast<unsigned char>(*p_) < 0x20) fail("управляющий символ в строке");
+                scratch_ += *p_++;
+                continue;
+            }
+            if (++p_ == end_) fail("незакрытая строка");
+            switch (*p_++) {
+            case '"': scratch_ += '"'; break;
+            case '\\': scratch_ += '\\'; break;
+            case '/': scratch_ += '/'; break;
+            case 'b': scratch_ += '\b'; break;
+            case 'f': scratch_ += '\f'; break;
+            case 'n': scratch_ += '\n'; break;
+            case 'r': scratch_ += '\r'; break;
+            case 't': scratch_ += '\t'; break;
+            case 'u': unicodeEscape(); break;
+            default: fail("неизвестное экранирование");
+            }
+        }
+        if (p_ == end_) fail("незакрытая строка");
+        ++p_;
+        if (writer_) writer_->string(scratch_.data(), scratch_.size());
+    }
+
+    uint32_t hex4() {
+        if (end_ - p_ < 4) fail("короткая последовательность \\u");
+        uint32_t code = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = *p_++;
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= c - '0';
+            else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+            else fail("некорректная последовательность \\u");
+        }
+        return code;
+    }
+
+    // \uXXXX (включая суррогатные пары) в UTF-8
+    void unicodeEscape() {
+        uint32_t code = hex4();
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            if (end_ - p_ < 6 || p_[0] != '\\' || p_[1] != 'u') fail("непарный суррогат");
+            p_ += 2;
+            const uint32_t low = hex4();
+            if (low < 0xDC00 || low > 0xDFFF) fail("непарный суррогат");
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            fail("непарный суррогат");
+        }
+        if (code < 0x80) {
+            scratch_ += static_cast<char>(code);
+        } else if (code < 0x800) {
+            scratch_ += static_cast<char>(0xC0 | (code >> 6));
+            scratch_ += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            scratch_ += static_cast<char>(0xE0 | (code >> 12));
+            scratch_ += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            scratch_ += static_cast<char>(0xF0 | (code >> 18));
+            scratch_ += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool digit() const { return p_ != end_ && *p_ >= '0' && *p_ <= '9'; }
+
+    void digits() {
+        if (!digit()) fail("некорректное число");
+        while (digit()) ++p_;
+    }
+
+    // Число по грамматике JSON: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    // (проверяется в обоих проходах, чтобы ошибка не зависела от прохода)
+    void number() {
+        const char* start = p_;
+        bool integer = true;
+        if (p_ != end_ && *p_ == '-') ++p_;
+        if (!digit()) fail("ожидается значение");
+        if (*p_ == '0') {
+            ++p_;
+        } else {
+            digits();
+        }
+        if (p_ != end_ && *p_ == '.') {
+            integer = false;
+            ++p_;
+            digits();
+        }
+        if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+            integer = false;
+            ++p_;
+            if (p_ != end_ && (*p_ == '+' || *p_ == '-')) ++p_;
+            digits();
+        }
+        if (!writer_) return;
+
+        if (integer) {
+            if (*start == '-') {
+                int64_t value;
+                auto res = std::from_chars(start, p_, value);
+                if (res.ec == std::errc() && res.ptr == p_) {
+                    if (value < 0) {
+                        writer_->negative(value);
+                    } else {
+                        writer_->uinteger(static_cast<uint64_t>(value));  // "-0"
+                    }
+                    return;
+                }
+            } else {
+                uint64_t value;
+                auto res = std::from_chars(start, p_, value);
+                if (res.ec == std::errc() && res.ptr == p_) {
+                    writer_->uinteger(value);
+                    return;
+                }
+            }
+            // Вне диапазона 64-битных целых — как число с плавающей точкой
+        }
+
+        // Текст числа уже проверен по грамматике
+        char buffer[64];
+        const size_t size = static_cast<size_t>(p_ - start);
+        if (size >= sizeof(buffer)) {
+            writer_->number(std::strtod(std::string(start, size).c_str(), nullptr));
+            return;
+        }
+        std::memcpy(buffer, start, size);
+        buffer[size] = '\0';
+        char* parsed = nullptr;
+        const double value = std::strtod(buffer, &parsed);
+        if (parsed != buffer + size) fail("некорректное число");
+        writer_->number(value);
+    }
+
+    const char* p_;
+    const char* end_;
+    std::vector<uint64_t>& counts_;
+    Writer* writer_;
+    size_t next_ = 0;
+    std::string scratch_;  // Строка с раскрытым экранированием
+};
+
+} // namespace
+
+void transcodeJson(std::string_view json, BinaryFormat format, std::string& out) {
+    // Проход 1: размеры контейнеров
+    std::vector<uint64_t> counts;
+    Transcoder(json, counts, nullptr).run();
+
+    // Проход 2: запись (двоичное представление не длиннее текста JSON)
+    out.clear();
+    out.reserve(json.size());
+    Writer writer(format, out);
+    Transcoder(json, counts, &writer).run();
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Компактные двоичные представления JSON
+enum class BinaryFormat {
+    Cbor,     // RFC 8949
+    MsgPack   // MessagePack
+};
+
+// Перекодирование JSON-текста в CBOR или MessagePack без построения
+// дерева (Json::Value): первый проход считает элементы контейнеров,
+// второй пишет значения в выходной буфер. Длины массивов и объектов
+// записываются точно (минимальные заголовки), числа — минимальным
+// целым типом или float32, если он представляет значение без потерь.
+// std::invalid_argument — некорректный JSON.
+void transcodeJson(std::string_view json, BinaryFormat format, std::string& out);
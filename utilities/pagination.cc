@@ -0,0 +1,79 @@
+#include "pagination.h"
+#include "json_response.h"
+#include "utilities.h"
+#include <drogon/utils/Utilities.h>
+#include <stdexcept>
+
+using namespace drogon;
+
+namespace {
+// Версия формата курсора (ключ внутри может поменяться вместе с сортировкой)
+constexpr char kCursorPrefix[] = "v1|";
+}
+
+// Разбор параметров страницы
+PageRequest parsePageRequest(const HttpRequestPtr& req) {
+    PageRequest page;
+    const std::string& limit = req->getParameter("limit");
+    const std::string& cursor = req->getParameter("cursor");
+
+    if (!limit.empty()) {
+        size_t pos = 0;
+        int value = 0;
+        try {
+            value = std::stoi(limit, &pos);
+        } catch (const std::exception&) {
+            pos = 0;
+        }
+        if (pos != limit.size() || value < 1 || value > kMaxPageLimit) {
+            throw std::invalid_argument("Параметр limit: целое от 1 до " + std::to_string(kMaxPageLimit));
+        }
+        page.limit = value;
+        page.enabled = true;
+    }
+
+    if (!cursor.empty()) {
+        std::string key;
+        if (!decodePageCursor(cursor, key)) {
+            throw std::invalid_argument("Некорректный параметр cursor");
+        }
+        page.after = std::move(key);
+        page.enabled = true;
+    }
+    return page;
+}
+
+// Кодирование ключа в курсор (base64url без дополнения)
+std::string encodePageCursor(const std::string& key) {
+    return utils::base64Encode(kCursorPrefix + key, true, false);
+}
+
+// Декодирование курсора; ключ должен быть датой YYYY-MM-DD
+bool decodePageCursor(const std::string& cursor, std::string& key) {
+    const std::string decoded = utils::base64Decode(cursor);
+    const std::string prefix = kCursorPrefix;
+    if (decoded.compare(0, prefix.size(), prefix) != 0) return false;
+    return normalizeDate(decoded.substr(prefix.size()), key);
+}
+
+// Ответ страницы: JSON элементов передается как есть
+HttpResponsePtr newPageResponse(const char* field, const orm::Row& row,
+                                std::optional<BinaryFormat> format) {
+    const bool hasMore = row["has_more"].as<bool>();
+    const auto& nextKey = row["next_key"];
+
+    std::string body = "{\"";
+    body += field;
+    body += "\":";
+    body += rawJson(row["items"]);
+    body += ",\"next_cursor\":";
+    if (hasMore && !nextKey.isNull()) {
+        body += '"';
+        body += encodePageCursor(nextKey.as<std::string>());
+        body += '"';
+    } else {
+        body += "null";
+    }
+    body += '}';
+    return newNegotiatedResponse(std::move(body), format);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+#include <drogon/orm/Result.h>
+#include "json_transcoder.h"
+#include <optional>
+#include <string>
+
+// Постраничная выдача по ключу (keyset): страница начинается строго после
+// ключа последнего элемента предыдущей страницы, условие передается в SQL.
+// Клиент получает ключ в виде непрозрачного курсора next_cursor.
+
+// Размер страницы по умолчанию и предел
+constexpr int kDefaultPageLimit = 100;
+constexpr int kMaxPageLimit = 1000;
+
+// Параметры страницы из запроса
+struct PageRequest {
+    bool enabled = false;              // Указан limit или cursor
+    int limit = kDefaultPageLimit;     // Размер страницы
+    std::optional<std::string> after;  // Ключ, после которого начинается страница
+};
+
+// Разбор limit и cursor; std::invalid_argument при ошибке
+PageRequest parsePageRequest(const drogon::HttpRequestPtr& req);
+
+// Непрозрачный курсор из ключа и обратно
+std::string encodePageCursor(const std::string& key);
+bool decodePageCursor(const std::string& cursor, std::string& key);
+
+// Ответ страницы из строки результата со столбцами
+// items (JSON страницы), next_key (ключ последнего элемента), has_more:
+// {"<field>": <items>, "next_cursor": "..." | null} в согласованном формате
+drogon::HttpResponsePtr newPageResponse(const char* field, const drogon::orm::Row& row,
+                                        std::optional<BinaryFormat> format);
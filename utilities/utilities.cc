@@ -3,6 +3,7 @@
 #include <memory>        // Для unique_ptr
 #include <stdexcept>     // Для исключений
 #include <stdio.h>       // Для popen/pclose
+#include <ctime>         // Для strptime/strftime
 
 // Функция обрезки пробелов в начале и конце строки
 std::string trim(const std::string& s) {
@@ -19,6 +20,23 @@ std::string trim(const std::string& s) {
     return std::string(start, end+1);
 }
 
+// Обрезка пробелов и табуляций по краям (для значений заголовков)
+std::string_view trimView(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// Сравнение без учета регистра (b — в нижнем регистре)
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const char x = a[i] >= 'A' && a[i] <= 'Z' ? a[i] - 'A' + 'a' : a[i];
+        if (x != b[i]) return false;
+    }
+    return true;
+}
+
 // Функция выполнения системной команды с захватом вывода
 std::string executeCommand(const char* cmd) {
     char buffer[128];  // Буфер для чтения вывода
@@ -40,4 +58,58 @@ std::string executeCommand(const char* cmd) {
     }
     
     return trim(result);  // Возвращаем обрезанный результат
-}
\ No newline at end of file
+}
+
+// Формирование строгого ETag из дайджеста (в кавычках, hex)
+std::string makeETag(const unsigned char* digest, size_t size) {
+    static const char hex[] = "0123456789abcdef";
+    std::string etag;
+    etag.reserve(size * 2 + 2);
+    etag += '"';
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char byte = digest[i];
+        etag += hex[byte >> 4];
+        etag += hex[byte & 0x0F];
+    }
+    etag += '"';
+    return etag;
+}
+
+// Проверка заголовка If-None-Match (список тегов через запятую или "*")
+bool etagMatches(const std::string& header, const std::string& etag) {
+    std::string_view rest(header);
+    while (!rest.empty()) {
+        const size_t comma = rest.find(',');
+        std::string_view tag = trimView(rest.substr(0, comma));
+        rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+        // Пустые элементы списка (",," или ведущая запятая) пропускаются
+        if (tag.empty()) continue;
+        // Для If-None-Match допускается слабое сравнение
+        if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+        if (tag == "*" || tag == etag) return true;
+    }
+    return false;
+}
+
+// Разбор даты YYYY-MM-DD и приведение к каноничному виду (ведущие нули)
+bool normalizeDate(const std::string& input, std::string& out) {
+    std::tm tm = {};
+    const char* end = strptime(input.c_str(), "%Y-%m-%d", &tm);
+    if (!end || *end != '\0') return false;
+
+    char buffer[16];
+    if (strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm) == 0) return false;
+    out = buffer;
+    return true;
+}
+
+// Сравнение каноничной даты с текущей локальной датой
+bool isPastDate(const std::string& date) {
+    std::time_t now = std::time(nullptr);
+    std::tm local = {};
+    localtime_r(&now, &local);
+
+    char today[16];
+    strftime(today, sizeof(today), "%Y-%m-%d", &local);
+    return date < today;
+}
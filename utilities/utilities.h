@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <unistd.h>      // Для работы с POSIX API (close)
 #include <stdexcept>     // Для исключений
@@ -30,4 +31,10 @@ public:
 
 // Прототипы функций:
 std::string trim(const std::string& s);           // Обрезка пробелов в строке
-std::string executeCommand(const char* cmd);      // Выполнение системной команды
\ No newline at end of file
+std::string_view trimView(std::string_view s);    // Обрезка пробелов и табуляций по краям (без копирования)
+bool equalsIgnoreCase(std::string_view a, std::string_view b); // Сравнение без учета регистра (b — в нижнем регистре)
+std::string executeCommand(const char* cmd);      // Выполнение системной команды
+std::string makeETag(const unsigned char* digest, size_t size); // Строгий ETag из дайджеста
+bool etagMatches(const std::string& header, const std::string& etag); // Проверка If-None-Match
+bool normalizeDate(const std::string& input, std::string& out); // Разбор даты в каноничный YYYY-MM-DD
+bool isPastDate(const std::string& date);         // Дата (YYYY-MM-DD) раньше сегодняшней
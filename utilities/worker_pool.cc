@@ -0,0 +1,82 @@
+#include "worker_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+// Конструктор: запуск рабочих потоков
+WorkerPool::WorkerPool(size_t threads, size_t maxQueued)
+    : maxQueued_(std::max<size_t>(maxQueued, 1)) {
+    threads = std::max<size_t>(threads, 1);
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back(&WorkerPool::run, this);
+    }
+}
+
+// Деструктор: выполнение оставшихся задач и остановка потоков
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) thread.join();
+}
+
+// Постановка одной задачи
+bool WorkerPool::trySubmit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.size() >= maxQueued_) return false;
+        queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+    return true;
+}
+
+// Параллельная обработка диапазона частями
+bool WorkerPool::parallelFor(size_t count, std::function<void(size_t)> fn, std::function<void()> done) {
+    const size_t parts = std::max<size_t>(std::min(count, threads_.size()), 1);
+
+    // Общее состояние частей: последняя завершившаяся вызывает done
+    struct State {
+        std::function<void(size_t)> fn;
+        std::function<void()> done;
+        std::atomic<size_t> remaining;
+    };
+    auto state = std::make_shared<State>();
+    state->fn = std::move(fn);
+    state->done = std::move(done);
+    state->remaining = parts;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Все части ставятся атомарно, чтобы не запустить пачку наполовину
+        if (stopping_ || queue_.size() + parts > maxQueued_) return false;
+        for (size_t part = 0; part < parts; ++part) {
+            const size_t begin = count * part / parts;
+            const size_t end = count * (part + 1) / parts;
+            queue_.push_back([state, begin, end] {
+                for (size_t i = begin; i < end; ++i) state->fn(i);
+                if (state->remaining.fetch_sub(1) == 1 && state->done) state->done();
+            });
+        }
+    }
+    cv_.notify_all();
+    return true;
+}
+
+// Цикл рабочего потока
+void WorkerPool::run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
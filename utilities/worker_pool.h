@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул рабочих потоков с ограниченной очередью задач.
+// Используется для тяжелых CPU-операций (шифрование пачек записей),
+// чтобы не занимать IO-потоки Drogon.
+class WorkerPool {
+public:
+    WorkerPool(size_t threads, size_t maxQueued);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Постановка задачи; false — очередь заполнена
+    bool trySubmit(std::function<void()> task);
+
+    // Асинхронная обработка индексов [0, count) на потоках пула.
+    // Диапазон делится на части по числу потоков; done вызывается
+    // в потоке пула после завершения последней части.
+    // false — в очереди нет места, ничего не запущено.
+    bool parallelFor(size_t count, std::function<void(size_t)> fn, std::function<void()> done);
+
+    size_t threadCount() const { return threads_.size(); }
+
+private:
+    void run();
+
+    std::vector<std::thread> threads_;          // Рабочие потоки
+    std::deque<std::function<void()>> queue_;   // Очередь задач
+    size_t maxQueued_;                          // Предел длины очереди
+    std::mutex mutex_;                          // Защита очереди
+    std::condition_variable cv_;                // Сигнал о новых задачах
+    bool stopping_ = false;                     // Флаг остановки
+};